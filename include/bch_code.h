@@ -1,12 +1,24 @@
 #ifndef BCH_CODE_H
 #define BCH_CODE_H
 
+#include "codeword_batch.h"
 #include "coding_strategy.h"
+#include "galois_field.h"
 #include <vector>
+#include <memory>
 #include <cstdint>
 
 /**
- * @brief Simple BCH error correction code implementation
+ * @brief Binary BCH error correction code over GF(2^m), 2 <= m <= 16
+ *
+ * A codeword is the k message bits followed by the n - k parity bits, bit i
+ * being the coefficient of x^(n-1-i). The generator has the roots
+ * alpha^1 .. alpha^2t. Shortened codes drop leading message bits, as in the
+ * DVB-S2 outer codes.
+ *
+ * Short codes (n < 64, n - k <= 16) are coded by table lookup: the parity
+ * is the remainder of the message bits, and the remainder of the received
+ * word indexes the error pattern directly.
  */
 class BCHCode : public CodingStrategy
 {
@@ -16,8 +28,10 @@ public:
    *
    * @param m Galois field parameter (GF(2^m))
    * @param t Error correction capability
+   * @param shortening Number of message bits removed from the full-length code
+   * @param polynomial Field polynomial, or 0 for the default one of GF(2^m)
    */
-  BCHCode(int m = 4, int t = 2);
+  BCHCode(int m = 4, int t = 2, int shortening = 0, int polynomial = 0);
 
   std::string getName() const override
   {
@@ -29,33 +43,238 @@ public:
     return "BCH codes are powerful cyclic error-correcting codes used in satellite communication and storage systems";
   }
 
-  std::vector<bool> encode(const std::vector<bool> &input) override;
-  std::pair<std::vector<bool>, int> decode(const std::vector<bool> &input) override;
+  std::unique_ptr<CodingStrategy> clone() const override
+  {
+    return std::make_unique<BCHCode>(*this);
+  }
+
+  size_t getMessageLength() const override { return k; }
+  size_t getCodewordLength() const override { return n; }
+
+  using CodingStrategy::encode;
+  using CodingStrategy::decode;
+
+  void encode(ConstBitSpan input, BitBuffer &output) override;
+  int decode(ConstBitSpan input, BitBuffer &output) override;
+
+  void encodeBatch(ConstBitSpan messages, BitSpan codewords) override;
+
+  /**
+   * @brief Decode whole codewords straight from the received range
+   *
+   * A codeword is reported as failed when its locator has more than t roots
+   * or roots outside the codeword; it is then left as received.
+   *
+   * @param codewords count * n received bits
+   * @param erasures Ignored
+   * @param messages Receives count * k decoded bits
+   * @param status Receives the outcome of each codeword (count entries, or nullptr)
+   * @return int The number of corrected bits
+   */
+  int decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                  CodewordStatus *status) override;
 
 private:
   int m; // Galois field parameter (GF(2^m))
   int t; // Error correction capability
-  int n; // Codeword length (2^m - 1)
-  int k; // Message length (n - mt)
+  int n; // Codeword length (2^m - 1 - shortening)
+  int k; // Message length (n - deg g)
 
-  // Galois field operations
-  std::vector<uint16_t> alphaTo; // index->polynomial form conversion table
-  std::vector<int> indexOf;      // polynomial->index form conversion table
+  // Lookup tables of GF(2^m), shared by all codes over the field
+  const GaloisField *field;
 
-  // Generator polynomial
+  // Generator polynomial, highest degree first
   std::vector<uint16_t> g;
 
-  // Initialize tables
-  void initTables();
-
-  // Generate generator polynomial
+  // Generate generator polynomial, the product of the minimal polynomials
+  // of alpha^1 .. alpha^2t
   void generatePolynomial();
 
-  // Compute syndrome for a received word
-  std::vector<uint16_t> computeSyndrome(const std::vector<bool> &received);
+  // Parity register layout: the coefficient of x^(n-k-1-q) of the remainder
+  // is bit q % 64 of word q / 64, so bit q is parity bit q of the codeword
+  int parityWords; // Words per remainder, ceil((n - k) / 64)
+
+  // x^(n-k) mod g(x), the feedback of a single message bit
+  std::vector<uint64_t> bitRow;
+
+  // Remainders of the 256 byte values shifted into the register
+  // (256 rows of parityWords words)
+  std::vector<uint64_t> byteRows;
+
+  // Eight byte tables for 64 message bits per step, used when n - k >= 64
+  std::vector<uint64_t> wordRows;
+
+  // Parity register of the current call
+  std::vector<uint64_t> parityRegister;
+
+  // Carry-less multiply folding of long messages: the message is consumed
+  // foldBits = 64 * foldWords bits at a time (foldBits >= n - k + 64, an
+  // even number of words up to 8), and word j of the running residue is
+  // folded forward with the constant x^(2 * foldBits - 65 - 64j) mod g(x)
+  // of foldWords - 1 words. Empty when n - k is too large to fold.
+  int foldBits;
+  int foldWords;
+  std::vector<uint64_t> foldConstants;
+  std::vector<uint64_t> foldBuffer;
+
+  // Build the encoder tables from g
+  void initEncoder();
+
+  // Feed bits through the table-driven LFSR, continuing from parityRegister
+  void feedRegister(ConstBitSpan bits);
+
+  /**
+   * @brief Compute the remainder of the received word modulo g(x)
+   *
+   * Runs the encoder LFSR over the received message and adds the received
+   * parity, so a clean codeword is rejected in one table-driven scan.
+   *
+   * @param received n received bits
+   * @return true The remainder (left in parityRegister) is nonzero
+   */
+  bool computeRemainder(ConstBitSpan received);
+
+  /**
+   * @brief Compute message(x) * x^(n-k) mod g(x) into parityRegister
+   *
+   * Long messages are first folded to a short residue with carry-less
+   * multiplication when the CPU has it; the residue and the remaining bits
+   * go through the table-driven LFSR.
+   *
+   * @param message The k message bits
+   */
+  void divideMessage(ConstBitSpan message);
+
+  /**
+   * @brief Compute the parity bits of one message
+   *
+   * @param message The k message bits
+   * @param parity Receives the n - k parity bits
+   */
+  void encodeParity(ConstBitSpan message, BitSpan parity);
+
+  /**
+   * @brief Compute the syndromes S_1 .. S_2t from the remainder in parityRegister
+   *
+   * The remainder is reduced modulo the minimal polynomial of each odd
+   * syndrome root, evaluated through per-syndrome byte tables, and each even
+   * syndrome is the square of S_(i/2).
+   *
+   * @param syndrome Receives 2t syndromes, syndrome[i] = S_(i+1)
+   */
+  void computeSyndromes(std::vector<uint16_t> &syndrome);
 
-  // Find error locations using Berlekamp-Massey algorithm
-  std::vector<int> findErrorLocations(const std::vector<uint16_t> &syndrome);
+  // Remainder tables of one minimal polynomial M(x), for division in the
+  // parity register layout (bit q is the coefficient of x^(degree-1-q))
+  struct MinimalPolynomial
+  {
+    int degree;
+    uint32_t bitRow;                // x^degree mod M
+    std::vector<uint32_t> byteRows; // v(x) * x^degree mod M for the 256 byte values
+  };
+
+  // Distinct minimal polynomials of the roots alpha^-i, i = 1, 3, .., 2t - 1
+  std::vector<MinimalPolynomial> minimalPolynomials;
+
+  // For each odd syndrome: its minimal polynomial, and two 256-entry tables
+  // mapping the low and high byte of a remainder to its share of S_i
+  std::vector<int> syndromePolynomial;
+  std::vector<uint16_t> syndromeTables;
+
+  // Remainders modulo each minimal polynomial and syndromes of the current call
+  std::vector<uint32_t> minimalRemainders;
+  std::vector<uint16_t> syndromeBuffer;
+
+  // Lane syndrome kernel: remainder byte q contributes to odd syndrome
+  // S_(2s+1) through four 16-entry tables at 64 * (s * remainderBytes + q),
+  // low and high nibble to the low byte, then low and high nibble to the
+  // high byte. Empty when the tables would be too large.
+  int remainderBytes; // ceil((n - k) / 8)
+  std::vector<uint8_t> laneSyndromeTables;
+
+  // Remainder bytes of the dirty codewords of a group, and their odd
+  // syndromes (row 2s the low bytes of S_(2s+1), row 2s + 1 the high bytes)
+  CodewordBatch laneRemainders;
+  CodewordBatch laneSyndromes;
+
+  /**
+   * @brief Expand the odd syndromes of one lane of laneSyndromes to S_1 .. S_2t
+   *
+   * @param lane Lane of the codeword
+   * @param syndrome Receives 2t syndromes, syndrome[i] = S_(i+1)
+   */
+  void laneSyndrome(size_t lane, std::vector<uint16_t> &syndrome) const;
+
+  // Decoder scratch space: polynomials (lowest degree first), the logs and
+  // degrees of the nonzero Chien terms, the byte planes and shuffle tables
+  // of the vector search, and the error positions found
+  std::vector<uint16_t> locator;
+  std::vector<uint16_t> previous;
+  std::vector<uint16_t> saved;
+  std::vector<int> termLog;
+  std::vector<int> termDegree;
+  std::vector<uint8_t> chienPlanes;
+  std::vector<uint8_t> chienTables;
+  std::vector<int> positions;
+
+  // Build the minimal polynomial and evaluation tables and the decoder scratch space
+  void initSyndromes();
+
+  // Decode table of a short code: remainders of each byte value at each
+  // byte of the codeword, and the error pattern (bit i for codeword bit i)
+  // of every remainder, UNCORRECTABLE beyond t errors
+  struct DecodeTable
+  {
+    std::vector<uint32_t> byteRemainders;
+    std::vector<uint64_t> patterns;
+  };
+
+  static constexpr int MAX_TABLE_PARITY = 16;
+  static constexpr uint64_t UNCORRECTABLE = ~uint64_t(0);
+
+  // Built on the first decode and shared by all codes with the same
+  // generator and length
+  std::shared_ptr<const DecodeTable> decodeTable;
+
+  bool useDecodeTable() const { return n < 64 && n - k <= MAX_TABLE_PARITY; }
+
+  /**
+   * @brief Get the decode table of this code, building it on first use
+   *
+   * @return const DecodeTable& The table, shared between instances
+   */
+  const DecodeTable &getDecodeTable();
+
+  /**
+   * @brief Fill a decode table by enumerating the error patterns of weight up to t
+   *
+   * @param table The table to fill
+   */
+  void buildDecodeTable(DecodeTable &table);
+
+  /**
+   * @brief Run the simplified inversionless Berlekamp-Massey algorithm on syndromeBuffer
+   *
+   * @return int The degree of the error locator, or -1 if it exceeds t
+   */
+  int findErrorLocator();
+
+  /**
+   * @brief Find the roots of the locator inside the codeword by a Chien search
+   *
+   * @param degree Degree of the locator
+   * @return int Number of roots found, stored in positions
+   */
+  int findErrorPositions(int degree);
+
+  /**
+   * @brief Correct one codeword from the syndromes in syndromeBuffer
+   *
+   * @param message The k message bits of the codeword, as received
+   * @param status Receives the outcome (or nullptr)
+   * @return int The number of corrected bits
+   */
+  int correctCodeword(BitSpan message, CodewordStatus *status);
 };
 
 #endif // BCH_CODE_H
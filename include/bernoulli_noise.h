@@ -0,0 +1,74 @@
+#ifndef BERNOULLI_NOISE_H
+#define BERNOULLI_NOISE_H
+
+#include <cstdint>
+#include "bit_buffer.h"
+#include "philox.h"
+
+/**
+ * @brief Independent bit flips with a fixed probability
+ *
+ * Building block shared by the channel models. Low probabilities are handled
+ * by gap sampling, whose cost scales with the number of flips; higher ones by
+ * generating 64 bits of noise per step.
+ */
+class BernoulliNoise
+{
+public:
+  /**
+   * @brief Construct a new Bernoulli Noise object
+   *
+   * @param probability Probability of a bit flip (clamped to 0.0 to 1.0)
+   */
+  explicit BernoulliNoise(double probability = 0.0);
+
+  /**
+   * @brief Set the flip probability and refresh the cached sampling constants
+   *
+   * @param probability Probability of a bit flip (clamped to 0.0 to 1.0)
+   */
+  void setProbability(double probability);
+
+  double getProbability() const { return probability; }
+
+  /**
+   * @brief Flip each bit of a range independently with the configured probability
+   *
+   * @param bits The bits to corrupt
+   * @param rng Source of randomness
+   */
+  void apply(BitSpan bits, Philox &rng) const;
+
+  /**
+   * @brief Sample the number of trials before the next event
+   *
+   * Returns a geometric variate with P(g) = (1 - p)^g * p, saturated at
+   * UINT64_MAX for vanishing probabilities.
+   *
+   * @param rng Source of randomness
+   * @return uint64_t Number of trials without an event
+   */
+  uint64_t sampleGap(Philox &rng) const;
+
+  /**
+   * @brief Probability below which apply() uses gap sampling
+   */
+  static constexpr double SPARSE_THRESHOLD = 0.1;
+
+private:
+  double probability;    // Probability of a bit flip (0.0 to 1.0)
+  double logComplement;  // log(1 - probability), cached for gap sampling
+  uint32_t rateFraction; // probability as a 32-bit binary fraction, for word-wide sampling
+  int rateLowestBit;     // Index of the lowest set bit of rateFraction
+
+  // Flip each bit independently, producing 64 bits of noise at a time
+  void applyDense(BitSpan bits, Philox &rng) const;
+
+  // Generate a word whose bits are independently 1 with probability rateFraction / 2^32
+  uint64_t noiseWord(Philox &rng) const;
+
+  // Flip bits by jumping over geometrically distributed runs of correct bits
+  void applySparse(BitSpan bits, Philox &rng) const;
+};
+
+#endif // BERNOULLI_NOISE_H
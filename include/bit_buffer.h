@@ -0,0 +1,320 @@
+#ifndef BIT_BUFFER_H
+#define BIT_BUFFER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Read-only view over a range of packed bits
+ *
+ * Bits are stored LSB-first in 64-bit words: bit i of the underlying storage
+ * lives in word i / 64 at position i % 64. A view may start at any bit offset.
+ */
+class ConstBitSpan
+{
+public:
+  ConstBitSpan() : wordPtr(nullptr), bitOffset(0), bitCount(0) {}
+
+  /**
+   * @brief Construct a view over existing word storage
+   *
+   * @param words Pointer to the first storage word
+   * @param offset Bit offset of the first bit in the view
+   * @param size Number of bits in the view
+   */
+  ConstBitSpan(const uint64_t *words, size_t offset, size_t size)
+      : wordPtr(words + offset / 64), bitOffset(offset % 64), bitCount(size) {}
+
+  size_t size() const { return bitCount; }
+  bool empty() const { return bitCount == 0; }
+
+  bool operator[](size_t i) const
+  {
+    size_t p = bitOffset + i;
+    return (wordPtr[p >> 6] >> (p & 63)) & 1;
+  }
+
+  /**
+   * @brief Read up to 64 consecutive bits
+   *
+   * @param pos Position of the first bit
+   * @param count Number of bits to read (1 to 64)
+   * @return uint64_t The bits, with bit pos in the least significant position
+   */
+  uint64_t getBits(size_t pos, int count) const
+  {
+    size_t p = bitOffset + pos;
+    size_t w = p >> 6;
+    int s = static_cast<int>(p & 63);
+    uint64_t value = wordPtr[w] >> s;
+    if (s != 0 && s + count > 64)
+    {
+      value |= wordPtr[w + 1] << (64 - s);
+    }
+    return count == 64 ? value : value & ((uint64_t(1) << count) - 1);
+  }
+
+  /**
+   * @brief Get a view over a sub-range of this view
+   *
+   * @param pos Position of the first bit
+   * @param count Number of bits
+   * @return ConstBitSpan The sub-range view
+   */
+  ConstBitSpan subspan(size_t pos, size_t count) const
+  {
+    return ConstBitSpan(wordPtr, bitOffset + pos, count);
+  }
+
+  /**
+   * @brief Count the set bits in the view
+   *
+   * @return size_t Number of bits equal to 1
+   */
+  size_t count() const;
+
+  /**
+   * @brief Convert the view to an unpacked bit vector
+   *
+   * @return std::vector<bool> The bits of the view
+   */
+  std::vector<bool> toVector() const;
+
+  const uint64_t *words() const { return wordPtr; }
+  size_t offset() const { return bitOffset; }
+
+private:
+  const uint64_t *wordPtr; // First word touched by the view
+  size_t bitOffset;        // Offset of the first bit inside *wordPtr (0-63)
+  size_t bitCount;         // Number of bits in the view
+};
+
+/**
+ * @brief Mutable view over a range of packed bits
+ */
+class BitSpan
+{
+public:
+  BitSpan() : wordPtr(nullptr), bitOffset(0), bitCount(0) {}
+
+  BitSpan(uint64_t *words, size_t offset, size_t size)
+      : wordPtr(words + offset / 64), bitOffset(offset % 64), bitCount(size) {}
+
+  operator ConstBitSpan() const { return ConstBitSpan(wordPtr, bitOffset, bitCount); }
+
+  size_t size() const { return bitCount; }
+  bool empty() const { return bitCount == 0; }
+
+  bool operator[](size_t i) const
+  {
+    size_t p = bitOffset + i;
+    return (wordPtr[p >> 6] >> (p & 63)) & 1;
+  }
+
+  void set(size_t i, bool value)
+  {
+    size_t p = bitOffset + i;
+    uint64_t mask = uint64_t(1) << (p & 63);
+    wordPtr[p >> 6] = value ? (wordPtr[p >> 6] | mask) : (wordPtr[p >> 6] & ~mask);
+  }
+
+  void flip(size_t i)
+  {
+    size_t p = bitOffset + i;
+    wordPtr[p >> 6] ^= uint64_t(1) << (p & 63);
+  }
+
+  uint64_t getBits(size_t pos, int count) const
+  {
+    return ConstBitSpan(*this).getBits(pos, count);
+  }
+
+  /**
+   * @brief Overwrite up to 64 consecutive bits
+   *
+   * @param pos Position of the first bit
+   * @param count Number of bits to write (1 to 64)
+   * @param value The bits, with bit pos in the least significant position
+   */
+  void setBits(size_t pos, int count, uint64_t value)
+  {
+    size_t p = bitOffset + pos;
+    size_t w = p >> 6;
+    int s = static_cast<int>(p & 63);
+    uint64_t mask = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+    value &= mask;
+    wordPtr[w] = (wordPtr[w] & ~(mask << s)) | (value << s);
+    if (s != 0 && s + count > 64)
+    {
+      wordPtr[w + 1] = (wordPtr[w + 1] & ~(mask >> (64 - s))) | (value >> (64 - s));
+    }
+  }
+
+  /**
+   * @brief XOR up to 64 consecutive bits with a pattern
+   *
+   * @param pos Position of the first bit
+   * @param count Number of bits affected (1 to 64)
+   * @param pattern The bits to XOR in, with bit pos in the least significant position
+   */
+  void xorBits(size_t pos, int count, uint64_t pattern)
+  {
+    size_t p = bitOffset + pos;
+    size_t w = p >> 6;
+    int s = static_cast<int>(p & 63);
+    if (count != 64)
+    {
+      pattern &= (uint64_t(1) << count) - 1;
+    }
+    wordPtr[w] ^= pattern << s;
+    if (s != 0 && s + count > 64)
+    {
+      wordPtr[w + 1] ^= pattern >> (64 - s);
+    }
+  }
+
+  BitSpan subspan(size_t pos, size_t count) const
+  {
+    return BitSpan(wordPtr, bitOffset + pos, count);
+  }
+
+  /**
+   * @brief Copy the contents of another view of the same size into this one
+   *
+   * @param source The bits to copy
+   */
+  void copyFrom(ConstBitSpan source);
+
+  /**
+   * @brief Set every bit in the view to the same value
+   *
+   * @param value The value to store
+   */
+  void fill(bool value);
+
+  uint64_t *words() const { return wordPtr; }
+  size_t offset() const { return bitOffset; }
+
+private:
+  uint64_t *wordPtr;
+  size_t bitOffset;
+  size_t bitCount;
+};
+
+/**
+ * @brief Growable bitstream backed by packed 64-bit words
+ *
+ * Replaces std::vector<bool> on the hot paths. Bits past size() in the last
+ * word are always kept zero, so whole-word operations (popcount, XOR compare)
+ * can be applied to the storage directly.
+ */
+class BitBuffer
+{
+public:
+  BitBuffer() : bitCount(0) {}
+
+  /**
+   * @brief Construct a zero-filled buffer
+   *
+   * @param size Number of bits
+   */
+  explicit BitBuffer(size_t size) : storage((size + 63) / 64, 0), bitCount(size) {}
+
+  /**
+   * @brief Construct a buffer from an unpacked bit vector
+   *
+   * @param bits The bits to pack
+   */
+  explicit BitBuffer(const std::vector<bool> &bits);
+
+  explicit BitBuffer(ConstBitSpan bits);
+
+  operator ConstBitSpan() const { return ConstBitSpan(storage.data(), 0, bitCount); }
+  operator BitSpan() { return BitSpan(storage.data(), 0, bitCount); }
+
+  ConstBitSpan view() const { return *this; }
+  BitSpan span() { return *this; }
+
+  size_t size() const { return bitCount; }
+  bool empty() const { return bitCount == 0; }
+  size_t wordCount() const { return storage.size(); }
+
+  uint64_t *data() { return storage.data(); }
+  const uint64_t *data() const { return storage.data(); }
+
+  /**
+   * @brief Change the number of bits; new bits are zero
+   *
+   * Does not allocate when the new size fits in the current capacity.
+   *
+   * @param size New number of bits
+   */
+  void resize(size_t size);
+
+  /**
+   * @brief Resize the buffer and clear every bit
+   *
+   * @param size New number of bits
+   */
+  void reset(size_t size);
+
+  void clear() { reset(0); }
+  void reserve(size_t size) { storage.reserve((size + 63) / 64); }
+
+  bool operator[](size_t i) const { return (storage[i >> 6] >> (i & 63)) & 1; }
+  bool get(size_t i) const { return (*this)[i]; }
+  void set(size_t i, bool value) { BitSpan(*this).set(i, value); }
+  void flip(size_t i) { storage[i >> 6] ^= uint64_t(1) << (i & 63); }
+
+  uint64_t getBits(size_t pos, int count) const { return ConstBitSpan(*this).getBits(pos, count); }
+  void setBits(size_t pos, int count, uint64_t value) { BitSpan(*this).setBits(pos, count, value); }
+
+  /**
+   * @brief Append a single bit
+   *
+   * @param value The bit to append
+   */
+  void pushBack(bool value);
+
+  /**
+   * @brief Append up to 64 bits
+   *
+   * @param value The bits, least significant first
+   * @param count Number of bits to append (1 to 64)
+   */
+  void appendBits(uint64_t value, int count);
+
+  /**
+   * @brief Append the contents of a view
+   *
+   * @param bits The bits to append
+   */
+  void append(ConstBitSpan bits);
+
+  /**
+   * @brief Replace the contents with those of a view
+   *
+   * @param bits The bits to copy
+   */
+  void assign(ConstBitSpan bits);
+
+  void assign(const std::vector<bool> &bits);
+
+  std::vector<bool> toVector() const { return view().toVector(); }
+
+  bool operator==(const BitBuffer &other) const
+  {
+    return bitCount == other.bitCount && storage == other.storage;
+  }
+  bool operator!=(const BitBuffer &other) const { return !(*this == other); }
+
+private:
+  std::vector<uint64_t> storage; // Packed bits, LSB-first
+  size_t bitCount;               // Number of valid bits
+
+  // Zero the unused bits of the last word
+  void clearTail();
+};
+
+#endif // BIT_BUFFER_H
@@ -0,0 +1,43 @@
+#ifndef CCSDS_REED_SOLOMON_H
+#define CCSDS_REED_SOLOMON_H
+
+#include "reed_solomon.h"
+
+/**
+ * @brief CCSDS 131.0-B Reed-Solomon (255,223) code
+ *
+ * GF(2^8) is built from x^8 + x^7 + x^2 + x + 1 and the generator has the
+ * roots (alpha^11)^j, j = 112 .. 143. Shortened codes drop leading data
+ * symbols (virtual fill), and I codewords can be interleaved symbol by
+ * symbol. Symbols are sent most significant bit first and, with the dual
+ * basis option, in Berlekamp's dual-basis representation.
+ */
+class CcsdsReedSolomon : public ReedSolomon
+{
+public:
+  /**
+   * @brief Construct a new CCSDS Reed-Solomon object
+   *
+   * @param interleave Interleave depth I (1 to 8)
+   * @param virtualFill Number of leading data symbols removed from each codeword (0 to 222)
+   * @param dualBasis Use the dual-basis symbol representation
+   */
+  CcsdsReedSolomon(int interleave = 1, int virtualFill = 0, bool dualBasis = true);
+
+  std::string getName() const override;
+
+  std::string getDescription() const override
+  {
+    return "CCSDS Reed-Solomon (255,223) corrects up to 16 symbol errors per codeword; used on deep-space and satellite telemetry links";
+  }
+
+  std::unique_ptr<CodingStrategy> clone() const override
+  {
+    return std::make_unique<CcsdsReedSolomon>(*this);
+  }
+
+private:
+  bool dualBasis;
+};
+
+#endif // CCSDS_REED_SOLOMON_H
@@ -2,12 +2,16 @@
 #define CHANNEL_H
 
 #include <vector>
-#include <random>
+#include <cstdint>
+#include "bit_buffer.h"
+#include "bernoulli_noise.h"
+#include "channel_model.h"
+#include "philox.h"
 
 /**
- * @brief Class that simulates a noisy communication channel
+ * @brief Binary symmetric channel: every bit flips independently with a fixed probability
  */
-class Channel
+class Channel : public ChannelModel
 {
 public:
   /**
@@ -18,12 +22,48 @@ public:
   Channel(double errorRate);
 
   /**
-   * @brief Transmit data through the noisy channel
+   * @brief Construct a new Channel object with a reproducible noise stream
    *
-   * @param input The bitstream to transmit
-   * @return std::vector<bool> The received bitstream with possible errors
+   * @param errorRate Probability of a bit flip (0.0 to 1.0)
+   * @param seed Seed of the run
+   * @param stream Noise stream within the run (e.g. one per worker or per work item)
+   */
+  Channel(double errorRate, uint64_t seed, uint64_t stream = 0);
+
+  /**
+   * @brief Switch to another noise stream and rewind it
+   *
+   * The noise applied after this call depends only on (seed, stream), so
+   * parallel workers produce identical results regardless of which thread
+   * processes which stream.
+   *
+   * @param seed Seed of the run
+   * @param stream Noise stream within the run
+   */
+  void reseed(uint64_t seed, uint64_t stream) override;
+
+  std::string getName() const override;
+  std::unique_ptr<ChannelModel> clone() const override;
+
+  /**
+   * @brief Position the noise stream at a given random block
+   *
+   * @param block Index of the next Philox block to consume
+   */
+  void seek(uint64_t block);
+
+  using ChannelModel::transmit;
+
+  /**
+   * @brief Transmit data through the noisy channel in place
+   *
+   * Below BernoulliNoise::SPARSE_THRESHOLD the distance to the next flipped
+   * bit is drawn from a geometric distribution, so the cost scales with the
+   * number of errors rather than the number of bits.
+   *
+   * @param bits The bitstream to transmit; errors are applied directly to it
    */
-  std::vector<bool> transmit(const std::vector<bool> &input);
+  void transmit(BitSpan bits) override;
 
   /**
    * @brief Set the bit error rate
@@ -37,12 +77,11 @@ public:
    *
    * @return double Current error rate
    */
-  double getErrorRate() const;
+  double getErrorRate() const override;
 
 private:
-  double errorRate;                            // Probability of a bit flip (0.0 to 1.0)
-  std::mt19937 rng;                            // Random number generator
-  std::uniform_real_distribution<double> dist; // Distribution for random numbers
+  BernoulliNoise noise; // Bit flip process at the configured error rate
+  Philox rng;           // Counter-based random number generator
 };
 
 #endif // CHANNEL_H
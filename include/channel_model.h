@@ -0,0 +1,65 @@
+#ifndef CHANNEL_MODEL_H
+#define CHANNEL_MODEL_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bit_buffer.h"
+
+/**
+ * @brief Abstract base class for noisy channel models
+ */
+class ChannelModel
+{
+public:
+  virtual ~ChannelModel() = default;
+
+  /**
+   * @brief Get a short description of the channel and its parameters
+   *
+   * @return std::string The name of the channel model
+   */
+  virtual std::string getName() const = 0;
+
+  /**
+   * @brief Create an independent copy of the channel, including its state
+   *
+   * @return std::unique_ptr<ChannelModel> The new instance
+   */
+  virtual std::unique_ptr<ChannelModel> clone() const = 0;
+
+  /**
+   * @brief Transmit data through the channel in place
+   *
+   * @param bits The bitstream to transmit; errors are applied directly to it
+   */
+  virtual void transmit(BitSpan bits) = 0;
+
+  /**
+   * @brief Switch to another noise stream and restart the channel from it
+   *
+   * The noise applied after this call depends only on (seed, stream).
+   *
+   * @param seed Seed of the run
+   * @param stream Noise stream within the run
+   */
+  virtual void reseed(uint64_t seed, uint64_t stream) = 0;
+
+  /**
+   * @brief Get the long-run average bit error rate of the channel
+   *
+   * @return double Average error rate
+   */
+  virtual double getErrorRate() const = 0;
+
+  /**
+   * @brief Transmit data through the channel
+   *
+   * @param input The bitstream to transmit
+   * @return std::vector<bool> The received bitstream with possible errors
+   */
+  std::vector<bool> transmit(const std::vector<bool> &input);
+};
+
+#endif // CHANNEL_MODEL_H
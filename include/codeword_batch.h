@@ -0,0 +1,86 @@
+#ifndef CODEWORD_BATCH_H
+#define CODEWORD_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Byte symbols of many codewords, stored symbol-major
+ *
+ * Row j holds symbol j of every codeword (lane), so one AVX2 instruction
+ * works on symbol j of 32 codewords. Rows are padded to whole groups of 32
+ * lanes; the padding lanes are zero after resize and are never loaded from
+ * or stored to a stream.
+ */
+class CodewordBatch
+{
+public:
+  // Lanes handled by one AVX2 vector
+  static constexpr size_t LANE_GROUP = 32;
+
+  CodewordBatch() = default;
+
+  /**
+   * @brief Construct a zeroed batch
+   *
+   * @param lanes Number of codewords
+   * @param symbols Symbols per codeword
+   */
+  CodewordBatch(size_t lanes, size_t symbols) { resize(lanes, symbols); }
+
+  /**
+   * @brief Change the shape of the batch and zero every symbol
+   *
+   * @param lanes Number of codewords
+   * @param symbols Symbols per codeword
+   */
+  void resize(size_t lanes, size_t symbols);
+
+  size_t lanes() const { return laneCount; }
+  size_t symbols() const { return symbolCount; }
+
+  // Bytes from one row to the next, a multiple of LANE_GROUP
+  size_t stride() const { return rowStride; }
+
+  uint8_t *row(size_t symbol) { return storage.data() + symbol * rowStride; }
+  const uint8_t *row(size_t symbol) const { return storage.data() + symbol * rowStride; }
+
+  uint8_t &at(size_t lane, size_t symbol) { return storage[symbol * rowStride + lane]; }
+  uint8_t at(size_t lane, size_t symbol) const { return storage[symbol * rowStride + lane]; }
+
+  /**
+   * @brief Transpose codewords from the stream layout into rows 0 .. count - 1
+   *
+   * Codeword b of the stream lives in block b / depth at offset b % depth,
+   * and its symbol j at blocks[(b / depth) * blockSize + b % depth + j * depth];
+   * with depth 1 the stream is plain row-major. Lane l receives codeword
+   * first + l. Row-major streams are transposed in 32 x 16 tiles.
+   *
+   * @param blocks The stream
+   * @param blockSize Symbols per block
+   * @param depth Codewords interleaved per block
+   * @param first Codeword of lane 0
+   * @param count Number of symbols to load, at most symbols()
+   */
+  void load(const uint8_t *blocks, size_t blockSize, size_t depth, size_t first, size_t count);
+
+  /**
+   * @brief Transpose rows 0 .. count - 1 back to the stream layout of load
+   *
+   * @param blocks The stream
+   * @param blockSize Symbols per block
+   * @param depth Codewords interleaved per block
+   * @param first Codeword of lane 0
+   * @param count Number of symbols to store, at most symbols()
+   */
+  void store(uint8_t *blocks, size_t blockSize, size_t depth, size_t first, size_t count) const;
+
+private:
+  size_t laneCount = 0;
+  size_t symbolCount = 0;
+  size_t rowStride = 0;
+  std::vector<uint8_t> storage;
+};
+
+#endif // CODEWORD_BATCH_H
@@ -2,6 +2,7 @@
 #define CODING_FACTORY_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <map>
@@ -9,6 +10,11 @@
 
 /**
  * @brief Factory class for creating error correction coding strategies
+ *
+ * Every call hands out an independent instance, so each thread can own its
+ * codecs. Instances are copied from a prototype built once per name or
+ * spec; the Galois field tables are shared by all of them. The factory may
+ * be used from several threads at once.
  */
 class CodingFactory
 {
@@ -29,12 +35,22 @@ public:
   void registerStrategy(const std::string &name, std::shared_ptr<CodingStrategy> strategy);
 
   /**
-   * @brief Create a coding strategy by name
+   * @brief Create a coding strategy by name or parameterized spec
    *
-   * @param name The name of the strategy to create
-   * @return std::shared_ptr<CodingStrategy> The created strategy
+   * Besides the registered names, the spec can be
+   * - RS(n,k): Reed-Solomon over the smallest GF(2^m) holding n symbols
+   *   (GF(2^16) past 255 symbols), or RS(n,k,m=M) for a given field
+   * - BCH(m=M,t=T): binary BCH over GF(2^M) correcting T errors, with
+   *   optional shorten=S leading message bits dropped and poly=P as the
+   *   field polynomial. P must be one with compiled field tables: the
+   *   default of each m, 0x187 for m = 8 or 0x1002D for m = 16
+   *   (see GaloisField::polynomials)
+   *
+   * @param spec The name or spec of the strategy to create
+   * @return std::unique_ptr<CodingStrategy> A new instance owned by the caller
+   * @throws std::invalid_argument If the spec is unknown or its parameters are invalid
    */
-  std::shared_ptr<CodingStrategy> createStrategy(const std::string &name);
+  std::unique_ptr<CodingStrategy> createStrategy(const std::string &spec);
 
   /**
    * @brief Get the list of available strategy names
@@ -44,12 +60,12 @@ public:
   std::vector<std::string> getStrategyNames() const;
 
   /**
-   * @brief Get a strategy description by name
+   * @brief Get a strategy description by name or spec
    *
-   * @param name The name of the strategy
+   * @param spec The name or spec of the strategy
    * @return std::string The description of the strategy
    */
-  std::string getStrategyDescription(const std::string &name) const;
+  std::string getStrategyDescription(const std::string &spec) const;
 
 private:
   // Private constructor to prevent direct instantiation
@@ -57,6 +73,22 @@ private:
 
   // Map of registered strategies
   std::map<std::string, std::shared_ptr<CodingStrategy>> strategies;
+
+  // Strategies built from specs, by spec with the spaces removed
+  mutable std::map<std::string, std::unique_ptr<CodingStrategy>> specPrototypes;
+
+  // Guards both maps
+  mutable std::mutex mutex;
+
+  /**
+   * @brief Find the prototype of a name or spec, building it on first use
+   *
+   * Must be called with mutex held.
+   *
+   * @param spec The name or spec
+   * @return const CodingStrategy& The prototype
+   */
+  const CodingStrategy &findPrototype(const std::string &spec) const;
 };
 
 #endif // CODING_FACTORY_H
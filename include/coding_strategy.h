@@ -5,6 +5,16 @@
 #include <string>
 #include <memory>
 #include <utility>
+#include "bit_buffer.h"
+
+/**
+ * @brief Outcome of decoding one codeword of a batch
+ */
+struct CodewordStatus
+{
+  int corrected = 0;   // Number of corrected errors
+  bool failed = false; // Errors were detected but could not be corrected
+};
 
 /**
  * @brief Abstract base class for error correction coding strategies
@@ -28,13 +38,101 @@ public:
    */
   virtual std::string getDescription() const = 0;
 
+  /**
+   * @brief Create an independent copy of the strategy
+   *
+   * Strategies keep per-call scratch state, so every thread needs its own copy.
+   *
+   * @return std::unique_ptr<CodingStrategy> The new instance
+   */
+  virtual std::unique_ptr<CodingStrategy> clone() const = 0;
+
+  /**
+   * @brief Get the number of message bits carried by one codeword
+   *
+   * @return size_t Message bits per codeword
+   */
+  virtual size_t getMessageLength() const = 0;
+
+  /**
+   * @brief Get the number of bits in one codeword
+   *
+   * @return size_t Encoded bits per codeword
+   */
+  virtual size_t getCodewordLength() const = 0;
+
+  /**
+   * @brief Encode a binary message into a caller-provided buffer
+   *
+   * Implementations reuse the capacity of the output buffer, so repeated calls
+   * with same-sized inputs do not allocate.
+   *
+   * @param input The input bitstream
+   * @param output Buffer that receives the encoded bitstream
+   */
+  virtual void encode(ConstBitSpan input, BitBuffer &output) = 0;
+
+  /**
+   * @brief Decode a received bitstream into a caller-provided buffer
+   *
+   * @param input The received bitstream
+   * @param output Buffer that receives the decoded bitstream (empty if the input is invalid)
+   * @return int The number of corrected errors
+   */
+  virtual int decode(ConstBitSpan input, BitBuffer &output) = 0;
+
+  /**
+   * @brief Decode a received bitstream with erasure flags
+   *
+   * Erasures mark received bits whose value is unreliable, e.g. after a loss
+   * of frame sync or from low-confidence soft decisions. Codes that can use
+   * them correct more errors at known positions; the default implementation
+   * ignores them.
+   *
+   * @param input The received bitstream
+   * @param erasures One flag per received bit, set where the bit is erased (empty for none)
+   * @param output Buffer that receives the decoded bitstream (empty if the input is invalid)
+   * @return int The number of corrected errors
+   */
+  virtual int decode(ConstBitSpan input, ConstBitSpan erasures, BitBuffer &output);
+
+  /**
+   * @brief Encode whole messages into a caller-provided range
+   *
+   * The messages are getMessageLength() bits each, back to back, and the
+   * codewords are written back to back without padding or allocation. The
+   * default implementation encodes one message at a time.
+   *
+   * @param messages count * getMessageLength() message bits
+   * @param codewords Receives count * getCodewordLength() bits
+   * @throws std::invalid_argument If the ranges do not hold the same number of messages and codewords
+   */
+  virtual void encodeBatch(ConstBitSpan messages, BitSpan codewords);
+
+  /**
+   * @brief Decode whole codewords into a caller-provided range
+   *
+   * The default implementation decodes one codeword at a time and, for a
+   * codeword without corrections, re-encodes the message to tell a clean
+   * codeword from one the decoder gave up on.
+   *
+   * @param codewords count * getCodewordLength() received bits
+   * @param erasures One flag per received bit (empty for none)
+   * @param messages Receives count * getMessageLength() decoded bits
+   * @param status Receives the outcome of each codeword (count entries, or nullptr)
+   * @return int The number of corrected errors in the batch
+   * @throws std::invalid_argument If the ranges do not hold the same number of codewords and messages
+   */
+  virtual int decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                          CodewordStatus *status);
+
   /**
    * @brief Encode a binary message
    *
    * @param input The input bitstream
    * @return std::vector<bool> The encoded bitstream
    */
-  virtual std::vector<bool> encode(const std::vector<bool> &input) = 0;
+  std::vector<bool> encode(const std::vector<bool> &input);
 
   /**
    * @brief Decode a received bitstream
@@ -42,7 +140,23 @@ public:
    * @param input The received bitstream
    * @return std::pair<std::vector<bool>, int> The decoded bitstream and number of corrected errors
    */
-  virtual std::pair<std::vector<bool>, int> decode(const std::vector<bool> &input) = 0;
+  std::pair<std::vector<bool>, int> decode(const std::vector<bool> &input);
+
+protected:
+  /**
+   * @brief Count the codewords of a batch
+   *
+   * @param messageBits Bits in the message range
+   * @param codewordBits Bits in the codeword range
+   * @return size_t Number of codewords
+   * @throws std::invalid_argument If the ranges do not hold the same whole number of messages and codewords
+   */
+  size_t batchSize(size_t messageBits, size_t codewordBits) const;
+
+private:
+  // Scratch buffers of the default batch implementations
+  BitBuffer batchBuffer;
+  BitBuffer checkBuffer;
 };
 
 #endif // CODING_STRATEGY_H
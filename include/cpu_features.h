@@ -0,0 +1,52 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+/**
+ * @brief Runtime detection of optional instruction set extensions
+ *
+ * Kernels that use these extensions are compiled with per-function target
+ * attributes and selected at runtime, so the binary still runs on CPUs
+ * without them.
+ */
+namespace CpuFeatures
+{
+  /**
+   * @brief Check for AVX2 and FMA support
+   *
+   * @return true AVX2 and FMA kernels can be used
+   */
+  bool hasAvx2();
+
+  /**
+   * @brief Check for SSSE3 support (byte shuffles)
+   *
+   * @return true SSSE3 kernels can be used
+   */
+  bool hasSsse3();
+
+  /**
+   * @brief Check for carry-less multiplication support
+   *
+   * @return true PCLMULQDQ kernels can be used
+   */
+  bool hasPclmul();
+
+  /**
+   * @brief Check for BMI2 support (PDEP/PEXT bit scatter and gather)
+   *
+   * @return true BMI2 kernels can be used
+   */
+  bool hasBmi2();
+
+  /**
+   * @brief Allow or forbid the optional extensions
+   *
+   * While they are forbidden every check above fails, so the portable code
+   * runs; tests use this to compare the kernels with it.
+   *
+   * @param enabled false to run the portable code only
+   */
+  void setEnabled(bool enabled);
+}
+
+#endif // CPU_FEATURES_H
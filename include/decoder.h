@@ -1,6 +1,7 @@
 #ifndef DECODER_H
 #define DECODER_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <utility>
@@ -31,10 +32,11 @@ private:
   /**
    * @brief Decode a 7-bit Hamming(7,4) encoded block and correct errors if possible
    *
-   * @param encodedBlock The 7-bit encoded block
-   * @return std::pair<std::vector<bool>, bool> The decoded 4-bit data and whether error was corrected
+   * @param encodedBlock The 7-bit encoded block, p1 in the least significant bit
+   * @param errorFixed Set to whether an error was corrected
+   * @return uint8_t The decoded 4-bit data, d1 in the least significant bit
    */
-  std::pair<std::vector<bool>, bool> decodeHamming74(const std::vector<bool> &encodedBlock);
+  uint8_t decodeHamming74(uint8_t encodedBlock, bool &errorFixed);
 };
 
 #endif // DECODER_H
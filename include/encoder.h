@@ -1,6 +1,7 @@
 #ifndef ENCODER_H
 #define ENCODER_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -30,10 +31,10 @@ private:
   /**
    * @brief Apply Hamming(7,4) encoding to a 4-bit data block
    *
-   * @param dataBits 4-bit data block
-   * @return std::vector<bool> 7-bit encoded block with error correction capability
+   * @param dataBits 4-bit data block, d1 in the least significant bit
+   * @return uint8_t 7-bit encoded block, p1 in the least significant bit
    */
-  std::vector<bool> encodeHamming74(const std::vector<bool> &dataBits);
+  uint8_t encodeHamming74(uint8_t dataBits);
 };
 
 #endif // ENCODER_H
@@ -0,0 +1,139 @@
+#ifndef GALOIS_FIELD_H
+#define GALOIS_FIELD_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Runtime view of the log/exp tables of one GF(2^m)
+ *
+ * Elements are in polynomial form, stored in uint16_t. log[0] is LOG_ZERO =
+ * 2 * order, and exp holds alpha^0 .. alpha^(order-1) twice followed by
+ * zeros up to index 4 * order. A product is then exp[log[a] + log[b]] for
+ * any a and b, with no modulo and no test for zero.
+ */
+struct GaloisField
+{
+  int m;          // Symbol size in bits
+  int size;       // Number of elements, 2^m
+  int order;      // Order of alpha, 2^m - 1
+  int polynomial; // Primitive polynomial, including the x^m term
+  const uint16_t *exp;
+  const uint32_t *log;
+
+  int logZero() const { return 2 * order; }
+
+  uint16_t mul(uint16_t a, uint16_t b) const { return exp[log[a] + log[b]]; }
+
+  // a / b for b != 0
+  uint16_t div(uint16_t a, uint16_t b) const { return exp[log[a] + order - log[b]]; }
+
+  // 1 / a for a != 0
+  uint16_t inv(uint16_t a) const { return exp[order - log[a]]; }
+
+  // alpha^e for any e >= 0
+  uint16_t alphaPow(int e) const { return exp[e % order]; }
+
+  /**
+   * @brief Get the tables of a field
+   *
+   * The tables are generated at compile time for the primitive polynomial of
+   * each m returned by defaultPolynomial, for the CCSDS polynomial 0x187 and
+   * for the DVB-S2 normal-frame BCH polynomial 0x1002D.
+   *
+   * @param m Symbol size in bits
+   * @param polynomial Primitive polynomial, including the x^m term
+   * @return const GaloisField& The field
+   * @throws std::invalid_argument If the field is not available
+   */
+  static const GaloisField &get(int m, int polynomial);
+
+  /**
+   * @brief Get the primitive polynomial used for GF(2^m) when none is given
+   *
+   * @param m Symbol size in bits
+   * @return int The polynomial, or 0 if there is none for m
+   */
+  static int defaultPolynomial(int m);
+
+  /**
+   * @brief Get the polynomials of GF(2^m) that get() has tables for
+   *
+   * @param m Symbol size in bits
+   * @return std::vector<int> The polynomials, the default one first (empty if there is none)
+   */
+  static std::vector<int> polynomials(int m);
+};
+
+/**
+ * @brief GF(2^M) generated by the primitive polynomial Poly, with tables built at compile time
+ */
+template <int M, int Poly>
+class GF
+{
+public:
+  static constexpr int SIZE = 1 << M;
+  static constexpr int ORDER = SIZE - 1;
+  static constexpr int LOG_ZERO = 2 * ORDER;
+
+  static_assert(M >= 2 && M <= 16, "GF(2^M) needs 2 <= M <= 16");
+  static_assert((Poly >> M) == 1, "Field polynomial must have degree M");
+
+  // alpha^i for i < 2 * ORDER, then zeros
+  static constexpr std::array<uint16_t, 4 * ORDER + 1> EXP = []
+  {
+    std::array<uint16_t, 4 * ORDER + 1> table{};
+    int x = 1;
+    for (int i = 0; i < ORDER; i++)
+    {
+      table[i] = static_cast<uint16_t>(x);
+      table[i + ORDER] = static_cast<uint16_t>(x);
+      x <<= 1;
+      if (x & SIZE)
+      {
+        x ^= Poly;
+      }
+    }
+    return table;
+  }();
+
+  // Discrete logarithms; 32 bits wide since LOG_ZERO exceeds 16 bits for M = 16
+  static constexpr std::array<uint32_t, SIZE> LOG = []
+  {
+    std::array<uint32_t, SIZE> table{};
+    table[0] = LOG_ZERO;
+    for (int i = 0; i < ORDER; i++)
+    {
+      table[EXP[i]] = static_cast<uint32_t>(i);
+    }
+    return table;
+  }();
+
+  static constexpr bool isPrimitive()
+  {
+    // alpha must run through every nonzero element before returning to 1
+    for (int i = 1; i < ORDER; i++)
+    {
+      if (EXP[i] == 1)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static constexpr uint16_t mul(uint16_t a, uint16_t b) { return EXP[LOG[a] + LOG[b]]; }
+  static constexpr uint16_t div(uint16_t a, uint16_t b) { return EXP[LOG[a] + ORDER - LOG[b]]; }
+  static constexpr uint16_t inv(uint16_t a) { return EXP[ORDER - LOG[a]]; }
+
+  // Runtime view of the tables
+  static const GaloisField &view()
+  {
+    static_assert(isPrimitive(), "Field polynomial is not primitive");
+    static const GaloisField field = {M, SIZE, ORDER, Poly, EXP.data(), LOG.data()};
+    return field;
+  }
+};
+
+#endif // GALOIS_FIELD_H
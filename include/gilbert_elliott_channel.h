@@ -0,0 +1,88 @@
+#ifndef GILBERT_ELLIOTT_CHANNEL_H
+#define GILBERT_ELLIOTT_CHANNEL_H
+
+#include <cstdint>
+#include "bernoulli_noise.h"
+#include "channel_model.h"
+#include "philox.h"
+
+/**
+ * @brief Two-state Gilbert-Elliott burst-error channel
+ *
+ * The channel alternates between a good and a bad state, each with its own
+ * bit error rate. Instead of stepping the Markov chain once per bit, the
+ * length of each stay in a state is drawn directly from its geometric
+ * distribution, and the whole run is corrupted in one pass of the sparse or
+ * word-wide noise generator. The cost per bit therefore matches the
+ * memoryless Channel, plus one draw per state change. The state carries over
+ * between transmit() calls, so consecutive frames see correlated fades.
+ */
+class GilbertElliottChannel : public ChannelModel
+{
+public:
+  /**
+   * @brief Construct a new Gilbert Elliott Channel object
+   *
+   * @param goodToBad Probability per bit of moving from the good to the bad state
+   * @param badToGood Probability per bit of moving from the bad to the good state
+   * @param goodErrorRate Bit error rate in the good state
+   * @param badErrorRate Bit error rate in the bad state
+   * @param seed Seed of the run
+   * @param stream Noise stream within the run
+   */
+  GilbertElliottChannel(double goodToBad, double badToGood,
+                        double goodErrorRate, double badErrorRate,
+                        uint64_t seed = 0, uint64_t stream = 0);
+
+  std::string getName() const override;
+  std::unique_ptr<ChannelModel> clone() const override;
+
+  using ChannelModel::transmit;
+  void transmit(BitSpan bits) override;
+
+  /**
+   * @brief Switch to another noise stream and restart the state process
+   *
+   * The initial state is drawn from the stationary distribution.
+   *
+   * @param seed Seed of the run
+   * @param stream Noise stream within the run
+   */
+  void reseed(uint64_t seed, uint64_t stream) override;
+
+  /**
+   * @brief Get the stationary average bit error rate
+   *
+   * @return double pi_good * goodErrorRate + pi_bad * badErrorRate
+   */
+  double getErrorRate() const override;
+
+  /**
+   * @brief Get the stationary probability of being in the bad state
+   *
+   * @return double goodToBad / (goodToBad + badToGood)
+   */
+  double getBadStateProbability() const;
+
+  /**
+   * @brief Check whether the channel is currently in the bad state
+   *
+   * @return true The next bit is sent in the bad state
+   */
+  bool isInBadState() const { return inBadState; }
+
+private:
+  BernoulliNoise leaveGood; // Per-bit probability of leaving the good state
+  BernoulliNoise leaveBad;  // Per-bit probability of leaving the bad state
+  BernoulliNoise goodNoise; // Bit errors in the good state
+  BernoulliNoise badNoise;  // Bit errors in the bad state
+  Philox rng;               // Counter-based random number generator
+
+  bool inBadState;       // Current state
+  uint64_t runRemaining; // Bits left before the next state change
+
+  // Draw the length of a new stay in the current state (at least one bit)
+  uint64_t sampleRunLength();
+};
+
+#endif // GILBERT_ELLIOTT_CHANNEL_H
@@ -2,9 +2,13 @@
 #define HAMMING_CODE_H
 
 #include "coding_strategy.h"
+#include <cstdint>
 
 /**
  * @brief Hamming(7,4) error correction code implementation
+ *
+ * Long streams are decoded bit-sliced, 64 codewords at a time (256 with
+ * AVX2), and the remainder through the Hamming74 lookup tables.
  */
 class HammingCode : public CodingStrategy
 {
@@ -19,25 +23,72 @@ public:
     return "Hamming(7,4) code can detect up to 2-bit errors and correct 1-bit errors per 7-bit block";
   }
 
-  std::vector<bool> encode(const std::vector<bool> &input) override;
-  std::pair<std::vector<bool>, int> decode(const std::vector<bool> &input) override;
+  std::unique_ptr<CodingStrategy> clone() const override
+  {
+    return std::make_unique<HammingCode>(*this);
+  }
+
+  size_t getMessageLength() const override { return 4; }
+  size_t getCodewordLength() const override { return 7; }
+
+  using CodingStrategy::encode;
+  using CodingStrategy::decode;
+
+  void encode(ConstBitSpan input, BitBuffer &output) override;
+  int decode(ConstBitSpan input, BitBuffer &output) override;
+
+  void encodeBatch(ConstBitSpan messages, BitSpan codewords) override;
+
+  /**
+   * @brief Decode whole codewords with the bit-sliced kernels
+   *
+   * Every 7-bit word is within one bit of a codeword, so no codeword is
+   * ever reported as failed; more than one error is miscorrected.
+   *
+   * @param codewords 7 * count received bits
+   * @param erasures Ignored
+   * @param messages Receives 4 * count decoded bits
+   * @param status Receives the outcome of each codeword (count entries, or nullptr)
+   * @return int The number of corrected codewords
+   */
+  int decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                  CodewordStatus *status) override;
 
 private:
+  /**
+   * @brief Encode output.size() / 7 blocks, padding the last message with zeros
+   *
+   * @param input The message bits
+   * @param output Receives the codewords
+   */
+  void encodeBlocks(ConstBitSpan input, BitSpan output);
+
+  /**
+   * @brief Decode input.size() / 7 blocks
+   *
+   * @param input The received bits
+   * @param output Receives 4 bits per block
+   * @param status Receives the outcome of each block (or nullptr)
+   * @return int The number of corrected blocks
+   */
+  int decodeBlocks(ConstBitSpan input, BitSpan output, CodewordStatus *status);
+
   /**
    * @brief Apply Hamming(7,4) encoding to a 4-bit data block
    *
-   * @param dataBits 4-bit data block
-   * @return std::vector<bool> 7-bit encoded block with error correction capability
+   * @param dataBits 4-bit data block, d1 in the least significant bit
+   * @return uint8_t 7-bit encoded block, p1 in the least significant bit
    */
-  std::vector<bool> encodeHamming74(const std::vector<bool> &dataBits);
+  uint8_t encodeHamming74(uint8_t dataBits);
 
   /**
    * @brief Decode a 7-bit Hamming(7,4) encoded block and correct errors if possible
    *
-   * @param encodedBlock The 7-bit encoded block
-   * @return std::pair<std::vector<bool>, bool> The decoded 4-bit data and whether error was corrected
+   * @param encodedBlock The 7-bit encoded block, p1 in the least significant bit
+   * @param errorFixed Set to whether an error was corrected
+   * @return uint8_t The decoded 4-bit data
    */
-  std::pair<std::vector<bool>, bool> decodeHamming74(const std::vector<bool> &encodedBlock);
+  uint8_t decodeHamming74(uint8_t encodedBlock, bool &errorFixed);
 };
 
 #endif // HAMMING_CODE_H
@@ -0,0 +1,121 @@
+#ifndef HAMMING_TABLES_H
+#define HAMMING_TABLES_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Lookup tables for Hamming(7,4), shared by HammingCode, Encoder and Decoder
+ *
+ * Codewords are stored with p1 in the least significant bit:
+ * [p1, p2, d1, p3, d2, d3, d4]. Data nibbles hold d1 in the least
+ * significant bit.
+ */
+namespace Hamming74
+{
+  // Set in a DECODE entry when the codeword had a nonzero syndrome
+  constexpr uint8_t CORRECTED = 0x10;
+  constexpr uint8_t DATA_MASK = 0x0F;
+
+  constexpr uint8_t encodeBlock(uint8_t data)
+  {
+    uint8_t d1 = data & 1;
+    uint8_t d2 = (data >> 1) & 1;
+    uint8_t d3 = (data >> 2) & 1;
+    uint8_t d4 = (data >> 3) & 1;
+
+    // p1 covers d1, d2, d4; p2 covers d1, d3, d4; p3 covers d2, d3, d4
+    uint8_t p1 = d1 ^ d2 ^ d4;
+    uint8_t p2 = d1 ^ d3 ^ d4;
+    uint8_t p3 = d2 ^ d3 ^ d4;
+
+    return static_cast<uint8_t>(p1 | (p2 << 1) | (d1 << 2) | (p3 << 3) |
+                                (d2 << 4) | (d3 << 5) | (d4 << 6));
+  }
+
+  constexpr uint8_t decodeBlock(uint8_t codeword)
+  {
+    // The syndrome is the 1-based position of a single flipped bit
+    uint8_t syndrome = 0;
+    for (int position = 1; position <= 7; position++)
+    {
+      if ((codeword >> (position - 1)) & 1)
+      {
+        syndrome ^= static_cast<uint8_t>(position);
+      }
+    }
+
+    uint8_t corrected = codeword;
+    if (syndrome != 0)
+    {
+      corrected ^= static_cast<uint8_t>(1 << (syndrome - 1));
+    }
+
+    uint8_t data = static_cast<uint8_t>(((corrected >> 2) & 1) | (((corrected >> 4) & 1) << 1) |
+                                        (((corrected >> 5) & 1) << 2) | (((corrected >> 6) & 1) << 3));
+    return static_cast<uint8_t>(data | (syndrome != 0 ? CORRECTED : 0));
+  }
+
+  constexpr std::array<uint8_t, 16> makeEncodeTable()
+  {
+    std::array<uint8_t, 16> table{};
+    for (int i = 0; i < 16; i++)
+    {
+      table[i] = encodeBlock(static_cast<uint8_t>(i));
+    }
+    return table;
+  }
+
+  constexpr std::array<uint8_t, 128> makeDecodeTable()
+  {
+    std::array<uint8_t, 128> table{};
+    for (int i = 0; i < 128; i++)
+    {
+      table[i] = decodeBlock(static_cast<uint8_t>(i));
+    }
+    return table;
+  }
+
+  // Data nibble -> 7-bit codeword
+  inline constexpr std::array<uint8_t, 16> ENCODE = makeEncodeTable();
+
+  // 7-bit received word -> corrected data nibble, plus CORRECTED if a bit was flipped
+  inline constexpr std::array<uint8_t, 128> DECODE = makeDecodeTable();
+
+  /**
+   * @brief Encode 8 data nibbles into 8 consecutive codewords
+   *
+   * @param data 32 data bits, first nibble in the least significant bits
+   * @return uint64_t 56 codeword bits, first codeword in the least significant bits
+   */
+  inline uint64_t encodeWord(uint32_t data)
+  {
+    uint64_t packed = 0;
+    for (int i = 0; i < 8; i++)
+    {
+      packed |= static_cast<uint64_t>(ENCODE[(data >> (4 * i)) & 0xF]) << (7 * i);
+    }
+    return packed;
+  }
+
+  /**
+   * @brief Decode 8 consecutive codewords into 8 data nibbles
+   *
+   * @param codewords 56 received bits, first codeword in the least significant bits
+   * @param corrected Incremented by the number of codewords that needed correction
+   * @return uint32_t 32 data bits, first nibble in the least significant bits
+   */
+  inline uint32_t decodeWord(uint64_t codewords, int &corrected)
+  {
+    uint32_t data = 0;
+    for (int i = 0; i < 8; i++)
+    {
+      uint8_t entry = DECODE[(codewords >> (7 * i)) & 0x7F];
+      data |= static_cast<uint32_t>(entry & DATA_MASK) << (4 * i);
+      corrected += entry >> 4;
+    }
+    return data;
+  }
+}
+
+#endif // HAMMING_TABLES_H
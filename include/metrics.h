@@ -6,6 +6,7 @@
 #include <chrono>
 #include <map>
 #include <iostream>
+#include "bit_buffer.h"
 
 /**
  * @brief Class for tracking and reporting communication performance metrics
@@ -46,6 +47,14 @@ public:
   void recordErrors(const std::vector<bool> &originalBits,
                     const std::vector<bool> &receivedBits);
 
+  /**
+   * @brief Record bit error information from packed bitstreams
+   *
+   * @param originalBits Original bits before transmission
+   * @param receivedBits Received bits after transmission
+   */
+  void recordErrors(ConstBitSpan originalBits, ConstBitSpan receivedBits);
+
   /**
    * @brief Record information about error correction
    *
@@ -0,0 +1,213 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Philox4x32-10 counter-based random number generator
+ *
+ * Each 128-bit output block is a pure function of (seed, stream, block index),
+ * so any block of any run can be regenerated in O(1), and independent streams
+ * can be handed to parallel workers without coordination. The generator
+ * satisfies UniformRandomBitGenerator and can be used with the standard
+ * <random> distributions.
+ */
+class Philox
+{
+public:
+  using result_type = uint64_t;
+
+  /**
+   * @brief Construct a new Philox object
+   *
+   * @param seed Key shared by every stream of a run
+   * @param stream Stream identifier; distinct streams never overlap
+   */
+  explicit Philox(uint64_t seed = 0, uint64_t stream = 0)
+      : key0(static_cast<uint32_t>(seed)), key1(static_cast<uint32_t>(seed >> 32)),
+        streamId(stream), counter(0), bufferPos(2) {}
+
+  /**
+   * @brief Select a new seed and stream and rewind to block 0
+   *
+   * @param seed Key shared by every stream of a run
+   * @param stream Stream identifier
+   */
+  void reseed(uint64_t seed, uint64_t stream)
+  {
+    key0 = static_cast<uint32_t>(seed);
+    key1 = static_cast<uint32_t>(seed >> 32);
+    streamId = stream;
+    seek(0);
+  }
+
+  /**
+   * @brief Position the generator at the start of a block
+   *
+   * @param block Index of the next block to generate
+   */
+  void seek(uint64_t block)
+  {
+    counter = block;
+    bufferPos = 2;
+  }
+
+  /**
+   * @brief Get the index of the next block to be generated
+   *
+   * @return uint64_t The block index
+   */
+  uint64_t tell() const { return counter; }
+
+  /**
+   * @brief Generate one block without changing the generator position
+   *
+   * @param block Index of the block
+   * @param out Receives the two 64-bit words of the block
+   */
+  void generate(uint64_t block, uint64_t out[2]) const
+  {
+    uint32_t c0 = static_cast<uint32_t>(block);
+    uint32_t c1 = static_cast<uint32_t>(block >> 32);
+    uint32_t c2 = static_cast<uint32_t>(streamId);
+    uint32_t c3 = static_cast<uint32_t>(streamId >> 32);
+    uint32_t k0 = key0;
+    uint32_t k1 = key1;
+
+    for (int round = 0; round < 10; round++)
+    {
+      uint64_t p0 = static_cast<uint64_t>(M0) * c0;
+      uint64_t p1 = static_cast<uint64_t>(M1) * c2;
+      uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+      uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+      c1 = static_cast<uint32_t>(p1);
+      c3 = static_cast<uint32_t>(p0);
+      c0 = n0;
+      c2 = n2;
+      k0 += W0;
+      k1 += W1;
+    }
+
+    out[0] = static_cast<uint64_t>(c1) << 32 | c0;
+    out[1] = static_cast<uint64_t>(c3) << 32 | c2;
+  }
+
+  /**
+   * @brief Fill an array with consecutive random words
+   *
+   * Produces the same words as repeated next() calls, but runs four
+   * independent blocks side by side so the multiply chains overlap.
+   *
+   * @param out Destination array
+   * @param count Number of 64-bit words to write
+   */
+  void fill(uint64_t *out, size_t count)
+  {
+    size_t i = 0;
+
+    // Drain a partially used block first
+    while (bufferPos != 2 && i < count)
+    {
+      out[i++] = buffer[bufferPos++];
+    }
+
+    for (; i + 8 <= count; i += 8)
+    {
+      generate4(counter, out + i);
+      counter += 4;
+    }
+
+    while (i < count)
+    {
+      out[i++] = next();
+    }
+  }
+
+  /**
+   * @brief Get the next 64 random bits
+   *
+   * @return uint64_t The random word
+   */
+  uint64_t next()
+  {
+    if (bufferPos == 2)
+    {
+      generate(counter++, buffer);
+      bufferPos = 0;
+    }
+    return buffer[bufferPos++];
+  }
+
+  uint64_t operator()() { return next(); }
+
+  /**
+   * @brief Get a uniform double in (0, 1]
+   *
+   * Never returns zero, so the result can be passed to log() directly.
+   *
+   * @return double The random value
+   */
+  double nextOpenUniform()
+  {
+    return static_cast<double>((next() >> 11) + 1) * (1.0 / 9007199254740992.0);
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+private:
+  // Generate four consecutive blocks starting at block into out[0..7]
+  void generate4(uint64_t block, uint64_t *out) const
+  {
+    uint32_t c0[4], c1[4], c2[4], c3[4];
+    for (int l = 0; l < 4; l++)
+    {
+      c0[l] = static_cast<uint32_t>(block + l);
+      c1[l] = static_cast<uint32_t>((block + l) >> 32);
+      c2[l] = static_cast<uint32_t>(streamId);
+      c3[l] = static_cast<uint32_t>(streamId >> 32);
+    }
+
+    uint32_t k0 = key0;
+    uint32_t k1 = key1;
+    for (int round = 0; round < 10; round++)
+    {
+      for (int l = 0; l < 4; l++)
+      {
+        uint64_t p0 = static_cast<uint64_t>(M0) * c0[l];
+        uint64_t p1 = static_cast<uint64_t>(M1) * c2[l];
+        uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+        c1[l] = static_cast<uint32_t>(p1);
+        c3[l] = static_cast<uint32_t>(p0);
+        c0[l] = n0;
+        c2[l] = n2;
+      }
+      k0 += W0;
+      k1 += W1;
+    }
+
+    for (int l = 0; l < 4; l++)
+    {
+      out[2 * l] = static_cast<uint64_t>(c1[l]) << 32 | c0[l];
+      out[2 * l + 1] = static_cast<uint64_t>(c3[l]) << 32 | c2[l];
+    }
+  }
+
+  static constexpr uint32_t M0 = 0xD2511F53;
+  static constexpr uint32_t M1 = 0xCD9E8D57;
+  static constexpr uint32_t W0 = 0x9E3779B9;
+  static constexpr uint32_t W1 = 0xBB67AE85;
+
+  uint32_t key0;
+  uint32_t key1;
+  uint64_t streamId;
+
+  uint64_t counter;   // Index of the next block to generate
+  uint64_t buffer[2]; // Current block
+  int bufferPos;      // Next unread word of buffer (2 = empty)
+};
+
+#endif // PHILOX_H
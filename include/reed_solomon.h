@@ -1,12 +1,19 @@
 #ifndef REED_SOLOMON_H
 #define REED_SOLOMON_H
 
+#include "codeword_batch.h"
 #include "coding_strategy.h"
+#include "galois_field.h"
+#include "rs_corrector.h"
 #include <vector>
 #include <cstdint>
 
 /**
  * @brief Simple Reed-Solomon error correction code implementation
+ *
+ * Symbols are stored highest-degree coefficient first: a codeword is the
+ * data symbols followed by the parity symbols. Inputs longer than one
+ * message are split into consecutive codewords.
  */
 class ReedSolomon : public CodingStrategy
 {
@@ -31,45 +38,251 @@ public:
     return "Reed-Solomon code can detect and correct multiple symbol errors, commonly used in CDs, DVDs, and deep-space communication";
   }
 
-  std::vector<bool> encode(const std::vector<bool> &input) override;
-  std::pair<std::vector<bool>, int> decode(const std::vector<bool> &input) override;
+  std::unique_ptr<CodingStrategy> clone() const override
+  {
+    return std::make_unique<ReedSolomon>(*this);
+  }
+
+  size_t getMessageLength() const override { return static_cast<size_t>(interleave) * dataSize * symbolSize; }
+  size_t getCodewordLength() const override { return static_cast<size_t>(interleave) * (dataSize + paritySize) * symbolSize; }
+
+  using CodingStrategy::encode;
+  using CodingStrategy::decode;
+
+  void encode(ConstBitSpan input, BitBuffer &output) override;
+  int decode(ConstBitSpan input, BitBuffer &output) override;
+
+  /**
+   * @brief Decode with erasures
+   *
+   * A symbol is erased when any of its bits is flagged. With e errors and
+   * f erasures in a codeword, it is corrected while 2e + f <= paritySize.
+   * Codewords with more than paritySize erasures are decoded as if none
+   * were flagged.
+   *
+   * @param input The received bitstream
+   * @param erasures One flag per received bit (empty for none)
+   * @param output Buffer that receives the decoded bitstream
+   * @return int The number of corrected symbols
+   */
+  int decode(ConstBitSpan input, ConstBitSpan erasures, BitBuffer &output) override;
+
+  void encodeBatch(ConstBitSpan messages, BitSpan codewords) override;
+
+  /**
+   * @brief Decode whole blocks of interleave codewords
+   *
+   * Groups of codewords are checked side by side by the lane kernels, as in
+   * decode. A block is reported as failed when any of its codewords had a
+   * nonzero syndrome that could not be corrected; it is then left as
+   * received.
+   *
+   * @param codewords count * getCodewordLength() received bits
+   * @param erasures One flag per received bit (empty for none)
+   * @param messages Receives count * getMessageLength() decoded bits
+   * @param status Receives the outcome of each block (count entries, or nullptr)
+   * @return int The number of corrected symbols
+   */
+  int decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                  CodewordStatus *status) override;
+
+protected:
+  /**
+   * @brief Construct a code over a given field and generator
+   *
+   * The generator has the roots beta^firstRoot .. beta^(firstRoot + paritySize - 1)
+   * with beta = alpha^rootStep. With an interleave depth I > 1, I codewords
+   * are sent symbol by symbol interleaved: symbol p of a block belongs to
+   * codeword p % I, for the data and then the parity symbols.
+   *
+   * @param symbolSize Symbol size in bits
+   * @param dataSize Data size in symbols
+   * @param paritySize Parity size in symbols
+   * @param fieldPolynomial Primitive polynomial of GF(2^symbolSize), including the x^symbolSize term
+   * @param firstRoot Exponent of beta for the first generator root
+   * @param rootStep Exponent of alpha giving beta, coprime to 2^symbolSize - 1
+   * @param interleave Interleave depth I
+   */
+  ReedSolomon(int symbolSize, int dataSize, int paritySize, int fieldPolynomial,
+              int firstRoot, int rootStep, int interleave);
+
+  /**
+   * @brief Translate symbols on their way in and out of the code
+   *
+   * Received and message symbols are mapped through inputMap before coding,
+   * and codeword and decoded symbols through outputMap after it, e.g. to
+   * change the symbol basis or bit order.
+   *
+   * @param inputMap 2^symbolSize entries, external to internal representation
+   * @param outputMap 2^symbolSize entries, internal to external representation
+   */
+  void setSymbolMaps(std::vector<uint8_t> inputMap, std::vector<uint8_t> outputMap);
 
-private:
   int symbolSize; // Symbol size in bits
   int dataSize;   // Number of data symbols
   int paritySize; // Number of parity symbols
-  int fieldSize;  // Field size (2^symbolSize)
+  int interleave; // Codewords interleaved per block
+
+private:
+  int fieldSize;       // Field size (2^symbolSize)
+  int fieldPolynomial; // Primitive polynomial of the field
+  int firstRoot;       // First generator root is beta^firstRoot
+  int rootStep;        // beta = alpha^rootStep
+
+  // Symbol translations (empty when symbols are used as they are)
+  std::vector<uint8_t> inputMap;
+  std::vector<uint8_t> outputMap;
+
+  // Galois Field multiplication
+  uint8_t gfMul(uint8_t a, uint8_t b) const;
+
+  // Conversion between bits and symbols (reusing the caller's storage)
+  void bitsToSymbols(ConstBitSpan bits, std::vector<uint8_t> &symbols);
+  void symbolsToBits(const std::vector<uint8_t> &symbols, BitSpan bits);
+
+  // Symbol scratch buffer reused across calls
+  std::vector<uint8_t> symbolBuffer;
 
-  // Galois Field arithmetic operations
-  uint8_t gfMul(uint8_t a, uint8_t b);
-  uint8_t gfDiv(uint8_t a, uint8_t b);
-  uint8_t gfInv(uint8_t a);
-  uint8_t gfPow(uint8_t a, int power);
+  // Codeword symbols of the current call
+  std::vector<uint8_t> codewordBuffer;
 
-  // Conversion between bits and symbols
-  std::vector<uint8_t> bitsToSymbols(const std::vector<bool> &bits);
-  std::vector<bool> symbolsToBits(const std::vector<uint8_t> &symbols);
+  // Erasure flags of the current call, one nonzero entry per erased symbol
+  std::vector<uint8_t> erasureBuffer;
 
-  // Reed-Solomon encoding/decoding on symbols
-  std::vector<uint8_t> encodeSymbols(const std::vector<uint8_t> &dataSymbols);
-  std::pair<std::vector<uint8_t>, int> decodeSymbols(const std::vector<uint8_t> &receivedSymbols);
+  // Errors-and-erasures correction of single codewords
+  RsCorrector<uint8_t> corrector;
+
+  /**
+   * @brief Encode the messages in symbolBuffer into codewordBuffer
+   *
+   * @param blockCount Number of blocks of interleave messages in symbolBuffer
+   */
+  void encodeBlocks(size_t blockCount);
+
+  /**
+   * @brief Correct the blocks in symbolBuffer and keep their data symbols in codewordBuffer
+   *
+   * @param blockCount Number of blocks in symbolBuffer
+   * @param status Receives the outcome of each block (or nullptr)
+   * @return int The number of corrected symbols
+   */
+  int decodeBlocks(size_t blockCount, CodewordStatus *status);
+
+  // Add the outcome of correcting one codeword to its block in status (if any)
+  void recordOutcome(size_t codeword, int fixed, CodewordStatus *status) const;
+
+  /**
+   * @brief Collect the erased symbols of one codeword
+   *
+   * @param codeword Index of the codeword
+   * @param positions Receives the codeword indices of its erased symbols
+   * @return int Number of erasures, or 0 if there are more than paritySize
+   */
+  int findErasures(size_t codeword, int *positions) const;
 
   // Generate generator polynomial for encoding
   std::vector<uint8_t> generatePolynomial();
 
-  // Syndrome computation and error correction
-  std::vector<uint8_t> computeSyndrome(const std::vector<uint8_t> &received);
-  std::vector<uint8_t> findErrorLocator(const std::vector<uint8_t> &syndrome);
-  std::vector<int> findErrorPositions(const std::vector<uint8_t> &errorLocator);
-  std::vector<uint8_t> findErrorValues(const std::vector<uint8_t> &syndrome,
-                                       const std::vector<int> &errorPositions);
+  // g(x) with roots beta^firstRoot .. beta^(firstRoot + paritySize - 1), highest degree first, g[0] = 1
+  std::vector<uint8_t> generator;
+
+  // One product row per LFSR feedback value v: byte j of the row is v * g[j + 1],
+  // packed eight bytes per word (byte j in bits 8 * (j % 8) of word j / 8)
+  std::vector<uint64_t> parityRows;
+  int rowWords; // Words per row, ceil(paritySize / 8)
+
+  // For each generator coefficient g[j + 1]: products with the 16 low nibbles, then the 16 high nibbles
+  std::vector<uint8_t> nibbleTables;
+
+  // Build the generator and the encoder tables
+  void initEncoder();
+
+  /**
+   * @brief Compute the parity of one codeword with the table-driven LFSR
+   *
+   * @param data dataSize data symbols
+   * @param parity Receives paritySize parity symbols
+   */
+  void encodeParity(const uint8_t *data, uint8_t *parity) const;
+
+  /**
+   * @brief Compute the parity of a batch of codewords
+   *
+   * Groups of 32 codewords run through the split-nibble shuffle kernel when
+   * AVX2 is available.
+   *
+   * @param data At least dataSize rows of data symbols
+   * @param parity Receives paritySize rows of parity symbols, same lanes as data
+   */
+  void encodeParityLanes(const CodewordBatch &data, CodewordBatch &parity) const;
+
+  // Data and parity of a lane group
+  CodewordBatch laneData;
+  CodewordBatch laneParity;
+
+  /**
+   * @brief Compute the syndromes S_i = r(beta^(firstRoot + i)), i = 0 .. paritySize - 1
+   *
+   * The received data is re-encoded and its parity compared with the
+   * received parity, so a clean codeword costs one LFSR pass. Syndromes are
+   * only evaluated, from the remainder, when the comparison fails.
+   *
+   * @param received dataSize + paritySize received symbols
+   * @param syndromes Receives paritySize syndromes (all zero for a clean codeword)
+   * @return true The codeword has errors
+   */
+  bool computeSyndromes(const uint8_t *received, uint8_t *syndromes);
+
+  /**
+   * @brief Evaluate the syndromes of a batch of codewords from their remainders
+   *
+   * @param remainders paritySize rows of remainder symbols
+   * @param syndromes Receives paritySize rows of syndromes, same lanes as remainders
+   */
+  void syndromesLanes(const CodewordBatch &remainders, CodewordBatch &syndromes);
+
+  /**
+   * @brief Correct the codewords of a lane group that have nonzero syndromes
+   *
+   * When enough of them have errors, their locators are searched for roots
+   * side by side by the AVX2 Chien kernel, and only Berlekamp-Massey and
+   * Forney run per codeword; otherwise each one is corrected on its own.
+   * Corrected data symbols are written back to symbolBuffer.
+   *
+   * @param first Codeword of lane 0
+   * @param status Receives the outcome of each block (or nullptr)
+   * @return int The number of corrected symbols
+   */
+  int correctLanes(size_t first, CodewordStatus *status);
+
+  // For each syndrome root beta^(firstRoot + i): products with the 16 low nibbles, then the 16 high nibbles
+  std::vector<uint8_t> syndromeNibbleTables;
+
+  // Nibble tables for the lane Chien search, for each locator term k = 1 .. paritySize:
+  // products with beta^(-k(n-1)), the term's value at codeword index 0, and with
+  // beta^k, its step from one index to the next
+  std::vector<uint8_t> chienStartTables;
+  std::vector<uint8_t> chienStepTables;
+
+  // Received codewords and syndromes of a lane group, and the syndromes of one codeword
+  CodewordBatch laneReceived;
+  CodewordBatch laneSyndromes;
+  std::vector<uint8_t> syndromeBuffer;
+
+  // Error locators of a lane group (row k holds Lambda_k) and their degrees
+  CodewordBatch laneLocators;
+  std::vector<int> laneDegrees;
+
+  // Lanes whose locator vanishes at each codeword index, and the roots of each lane
+  std::vector<uint32_t> rootMasks;
+  std::vector<int> laneRoots;
+  std::vector<int> laneRootCounts;
 
-  // Lookup tables for faster operations
-  std::vector<uint8_t> expTable;
-  std::vector<uint8_t> logTable;
+  // Lookup tables of GF(2^symbolSize), shared by all codes over the field
+  const GaloisField *field;
 
-  // Initialize lookup tables
-  void initTables();
+  // log(beta^(firstRoot + i))
+  int rootLog(int i) const;
 };
 
 #endif // REED_SOLOMON_H
@@ -0,0 +1,138 @@
+#ifndef REED_SOLOMON16_H
+#define REED_SOLOMON16_H
+
+#include "coding_strategy.h"
+#include "galois_field.h"
+#include "rs_corrector.h"
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Reed-Solomon code over GF(2^16) for long codewords
+ *
+ * Codewords hold up to 65535 16-bit symbols, so large blocks are protected
+ * by a few long codewords instead of many short GF(2^8) ones. The layout
+ * follows ReedSolomon: data symbols then parity, highest degree first, and
+ * the generator roots are alpha^0 .. alpha^(paritySize - 1).
+ */
+class ReedSolomon16 : public CodingStrategy
+{
+public:
+  /**
+   * @brief Construct a new GF(2^16) Reed Solomon object
+   *
+   * @param dataSize Data size in symbols
+   * @param paritySize Parity size in symbols
+   */
+  ReedSolomon16(int dataSize = 4096, int paritySize = 64);
+
+  std::string getName() const override
+  {
+    return "Reed-Solomon16(" + std::to_string(dataSize) + "," +
+           std::to_string(dataSize + paritySize) + ")";
+  }
+
+  std::string getDescription() const override
+  {
+    return "Reed-Solomon code over GF(2^16) with codewords of thousands of symbols, for protecting large file-delivery blocks";
+  }
+
+  std::unique_ptr<CodingStrategy> clone() const override
+  {
+    return std::make_unique<ReedSolomon16>(*this);
+  }
+
+  size_t getMessageLength() const override { return static_cast<size_t>(dataSize) * 16; }
+  size_t getCodewordLength() const override { return static_cast<size_t>(dataSize + paritySize) * 16; }
+
+  using CodingStrategy::encode;
+  using CodingStrategy::decode;
+
+  void encode(ConstBitSpan input, BitBuffer &output) override;
+  int decode(ConstBitSpan input, BitBuffer &output) override;
+
+  /**
+   * @brief Decode with erasures
+   *
+   * A symbol is erased when any of its bits is flagged; a codeword is
+   * corrected while 2 * errors + erasures <= paritySize.
+   *
+   * @param input The received bitstream
+   * @param erasures One flag per received bit (empty for none)
+   * @param output Buffer that receives the decoded bitstream
+   * @return int The number of corrected symbols
+   */
+  int decode(ConstBitSpan input, ConstBitSpan erasures, BitBuffer &output) override;
+
+  void encodeBatch(ConstBitSpan messages, BitSpan codewords) override;
+
+  /**
+   * @brief Decode whole codewords, reporting those that could not be corrected
+   *
+   * @param codewords count * getCodewordLength() received bits
+   * @param erasures One flag per received bit (empty for none)
+   * @param messages Receives count * getMessageLength() decoded bits
+   * @param status Receives the outcome of each codeword (count entries, or nullptr)
+   * @return int The number of corrected symbols
+   */
+  int decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                  CodewordStatus *status) override;
+
+private:
+  int dataSize;   // Number of data symbols
+  int paritySize; // Number of parity symbols
+
+  // GF(2^16) tables
+  const GaloisField *field;
+
+  // g(x), highest degree first, g[0] = 1
+  std::vector<uint16_t> generator;
+
+  // LFSR feedback products packed four symbols per word (symbol j in bits
+  // 16 * (j % 4) of word j / 4): v * g[j + 1] for the low byte v, then for
+  // the high byte v << 8, 256 rows each
+  std::vector<uint64_t> lowRows;
+  std::vector<uint64_t> highRows;
+  int rowWords; // Words per row, ceil(paritySize / 4)
+
+  // Scratch buffers reused across calls
+  std::vector<uint16_t> symbolBuffer;
+  std::vector<uint16_t> codewordBuffer;
+  std::vector<uint16_t> erasureBuffer;
+  std::vector<uint16_t> remainderBuffer;
+  std::vector<uint16_t> syndromeBuffer;
+  std::vector<uint64_t> registerBuffer;
+  std::vector<int> erasurePositions;
+
+  // Errors-and-erasures correction of single codewords
+  RsCorrector<uint16_t> corrector;
+
+  // Build the generator and the LFSR tables
+  void initEncoder();
+
+  // Encode the messages in symbolBuffer into codewordBuffer
+  void encodeBlocks(size_t blocks);
+
+  /**
+   * @brief Correct the codewords in symbolBuffer and keep their data symbols in codewordBuffer
+   *
+   * @param blocks Number of codewords in symbolBuffer
+   * @param status Receives the outcome of each codeword (or nullptr)
+   * @return int The number of corrected symbols
+   */
+  int decodeBlocks(size_t blocks, CodewordStatus *status);
+
+  /**
+   * @brief Compute the parity of one codeword with the table-driven LFSR
+   *
+   * @param data dataSize data symbols
+   * @param parity Receives paritySize parity symbols
+   */
+  void encodeParity(const uint16_t *data, uint16_t *parity);
+
+  // Conversion between bits and symbols (reusing the caller's storage)
+  void bitsToSymbols(ConstBitSpan bits, std::vector<uint16_t> &symbols) const;
+  void symbolsToBits(const std::vector<uint16_t> &symbols, BitSpan bits) const;
+};
+
+#endif // REED_SOLOMON16_H
@@ -0,0 +1,147 @@
+#ifndef RS_CORRECTOR_H
+#define RS_CORRECTOR_H
+
+#include "galois_field.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Errors-and-erasures corrector shared by the Reed-Solomon codecs
+ *
+ * Works on one codeword of dataSize + paritySize symbols, highest-degree
+ * coefficient first, of a code whose generator has the roots
+ * beta^firstRoot .. beta^(firstRoot + paritySize - 1), beta = alpha^rootStep.
+ * All scratch space is allocated once, at construction.
+ *
+ * @tparam Symbol uint8_t for GF(2^m), m <= 8, or uint16_t for m <= 16
+ */
+template <typename Symbol>
+class RsCorrector
+{
+public:
+  RsCorrector() = default;
+
+  /**
+   * @brief Construct a corrector for one code
+   *
+   * @param field The symbol field
+   * @param dataSize Data symbols per codeword
+   * @param paritySize Parity symbols per codeword
+   * @param firstRoot Exponent of beta for the first generator root
+   * @param rootStep Exponent of alpha giving beta
+   */
+  RsCorrector(const GaloisField &field, int dataSize, int paritySize, int firstRoot, int rootStep);
+
+  /**
+   * @brief Evaluate the syndromes from the remainder r(x) mod g(x)
+   *
+   * @param remainder paritySize remainder symbols, highest degree first
+   * @param syndromes Receives paritySize syndromes
+   */
+  void syndromesFromRemainder(const Symbol *remainder, Symbol *syndromes);
+
+  /**
+   * @brief Correct one codeword in place
+   *
+   * @param codeword dataSize + paritySize received symbols
+   * @param syndromes The paritySize syndromes of the codeword, not all zero
+   * @param erasures Codeword indices of the erased symbols
+   * @param erasureCount Number of erasures, at most paritySize
+   * @return int Number of corrected symbols (0 if the codeword could not be corrected; it is then left unchanged)
+   */
+  int correct(Symbol *codeword, const Symbol *syndromes, const int *erasures, int erasureCount);
+
+  /**
+   * @brief Find the error locator of one codeword, for a root search done elsewhere
+   *
+   * @param syndromes The paritySize syndromes of the codeword
+   * @param erasures Codeword indices of the erased symbols
+   * @param erasureCount Number of erasures, at most paritySize
+   * @param lambda Receives Lambda_0 .. Lambda_paritySize (lowest degree first)
+   * @return int The degree of Lambda, or -1 if 2 * errors + erasures > paritySize
+   */
+  int locate(const Symbol *syndromes, const int *erasures, int erasureCount, Symbol *lambda);
+
+  /**
+   * @brief Correct one codeword in place from its locator and the roots found for it
+   *
+   * @param codeword dataSize + paritySize received symbols
+   * @param syndromes The paritySize syndromes of the codeword
+   * @param erasures Codeword indices of the erased symbols
+   * @param erasureCount Number of erasures, at most paritySize
+   * @param lambda The locator from locate
+   * @param degree The degree returned by locate
+   * @param roots Codeword indices where Lambda vanishes, in increasing order
+   * @param rootCount Number of roots
+   * @return int Number of corrected symbols (0 if the codeword could not be corrected; it is then left unchanged)
+   */
+  int correct(Symbol *codeword, const Symbol *syndromes, const int *erasures, int erasureCount,
+              const Symbol *lambda, int degree, const int *roots, int rootCount);
+
+private:
+  const GaloisField *field = nullptr;
+  int dataSize = 0;
+  int paritySize = 0;
+  int firstRoot = 0;
+  int rootStep = 1;
+
+  // Scratch polynomials (lowest degree first) and per-root values
+  std::vector<Symbol> locator;
+  std::vector<Symbol> previous;
+  std::vector<Symbol> saved;
+  std::vector<Symbol> evaluator;
+  std::vector<Symbol> values;
+  std::vector<int> positions;
+  std::vector<int> termLog;
+  std::vector<int> termStep;
+
+  /**
+   * @brief Run Berlekamp-Massey on the syndromes into locator
+   *
+   * With erasures, the iteration starts from the erasure locator
+   * Gamma(x) = prod (1 - X_j x) and finds the combined locator of the
+   * erasures and the unknown errors.
+   *
+   * @param syndromes paritySize syndromes
+   * @param erasures Codeword indices of the erased symbols
+   * @param erasureCount Number of erasures, at most paritySize
+   * @return int The degree of Lambda, or -1 if 2 * errors + erasures > paritySize
+   */
+  int findErrorLocator(const Symbol *syndromes, const int *erasures, int erasureCount);
+
+  /**
+   * @brief Find the roots of the locator by an incremental Chien search
+   *
+   * Stops as soon as degree roots have been found.
+   *
+   * @param degree Degree of the locator
+   * @return int Number of roots found inside the codeword, stored in positions
+   */
+  int findErrorPositions(int degree);
+
+  /**
+   * @brief Compute the error magnitudes at positions with Forney's algorithm
+   *
+   * @param syndromes paritySize syndromes
+   * @param degree Degree of the locator, and number of positions
+   * @return true All magnitudes are valid (zero for an erased symbol that was right)
+   */
+  bool findErrorValues(const Symbol *syndromes, int degree);
+
+  /**
+   * @brief Compute the magnitudes at the degree positions and apply them
+   *
+   * @param codeword The received symbols
+   * @param syndromes paritySize syndromes
+   * @param erasures Codeword indices of the erased symbols
+   * @param erasureCount Number of erasures
+   * @param degree Degree of the locator, and number of positions
+   * @return int Number of corrected symbols, 0 if the magnitudes are inconsistent
+   */
+  int applyCorrections(Symbol *codeword, const Symbol *syndromes, const int *erasures, int erasureCount, int degree);
+};
+
+extern template class RsCorrector<uint8_t>;
+extern template class RsCorrector<uint16_t>;
+
+#endif // RS_CORRECTOR_H
@@ -0,0 +1,115 @@
+#ifndef SEGMENTED_CODE_H
+#define SEGMENTED_CODE_H
+
+#include "coding_strategy.h"
+#include "thread_pool.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Framing layer that carries bitstreams of any length over a block code
+ *
+ * The stream is prefixed with its length, padded with zeros to whole
+ * messages of the inner code and encoded codeword by codeword; decoding
+ * corrects every codeword and strips the header and the padding again.
+ * Codewords are independent, so with a thread pool they are split across
+ * the workers, each using its own copy of the inner code. Once the buffers
+ * have grown to the stream size, further calls do not allocate.
+ */
+class SegmentedCode : public CodingStrategy
+{
+public:
+  /**
+   * @brief Construct a new Segmented Code object
+   *
+   * @param code The inner block code
+   * @param pool Workers to spread the codewords over (nullptr to run on the calling thread)
+   */
+  explicit SegmentedCode(std::unique_ptr<CodingStrategy> code, std::shared_ptr<ThreadPool> pool = nullptr);
+
+  /**
+   * @brief Copy a Segmented Code object
+   *
+   * The copy gets its own inner code and shares the thread pool.
+   *
+   * @param other The object to copy
+   */
+  SegmentedCode(const SegmentedCode &other);
+
+  std::string getName() const override { return code->getName(); }
+  std::string getDescription() const override { return code->getDescription(); }
+
+  std::unique_ptr<CodingStrategy> clone() const override
+  {
+    return std::make_unique<SegmentedCode>(*this);
+  }
+
+  // Lengths of one inner codeword; streams of any length are accepted
+  size_t getMessageLength() const override { return code->getMessageLength(); }
+  size_t getCodewordLength() const override { return code->getCodewordLength(); }
+
+  using CodingStrategy::encode;
+  using CodingStrategy::decode;
+
+  /**
+   * @brief Frame and encode a bitstream of any length
+   *
+   * @param input The input bitstream, at most 2^32 - 1 bits
+   * @param output Buffer that receives the concatenated codewords
+   */
+  void encode(ConstBitSpan input, BitBuffer &output) override;
+
+  int decode(ConstBitSpan input, BitBuffer &output) override;
+  int decode(ConstBitSpan input, ConstBitSpan erasures, BitBuffer &output) override;
+
+  /**
+   * @brief Encode whole messages of the inner code, without framing
+   *
+   * @param messages count * getMessageLength() message bits
+   * @param codewords Receives count * getCodewordLength() bits
+   */
+  void encodeBatch(ConstBitSpan messages, BitSpan codewords) override;
+
+  /**
+   * @brief Decode whole codewords of the inner code, without framing
+   *
+   * @param codewords count * getCodewordLength() received bits
+   * @param erasures One flag per received bit (empty for none)
+   * @param messages Receives count * getMessageLength() decoded bits
+   * @param status Receives the outcome of each codeword (count entries, or nullptr)
+   * @return int The number of corrected errors
+   */
+  int decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                  CodewordStatus *status) override;
+
+  // Bits of the length header in front of the stream
+  static constexpr int LENGTH_BITS = 32;
+
+private:
+  std::unique_ptr<CodingStrategy> code;
+  std::shared_ptr<ThreadPool> pool;
+
+  // Copies of the inner code, one per worker
+  std::vector<std::unique_ptr<CodingStrategy>> workerCodes;
+
+  // The framed stream: length header, data and padding
+  BitBuffer frameBuffer;
+
+  // Corrected errors of each task
+  std::vector<int> taskErrors;
+
+  /**
+   * @brief Run body(task, first, count, code) over the codewords in tasks
+   *
+   * Task boundaries fall on whole 64-bit words of both the messages and the
+   * codewords, so tasks never write to the same word of a shared buffer.
+   *
+   * @param codewords Number of codewords
+   * @param body Work on codewords [first, first + count) with a worker's code
+   * @return size_t Number of tasks run
+   */
+  size_t forEachTask(size_t codewords,
+                     const std::function<void(size_t task, size_t first, size_t count, CodingStrategy &code)> &body);
+};
+
+#endif // SEGMENTED_CODE_H
@@ -0,0 +1,109 @@
+#ifndef SWEEP_ENGINE_H
+#define SWEEP_ENGINE_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ChannelModel;
+class ThreadPool;
+
+/**
+ * @brief Settings for a batch BER/FER sweep
+ */
+struct SweepConfig
+{
+  std::vector<std::string> strategies; // Strategy names (empty = all registered strategies)
+  std::vector<double> errorRates;      // Channel bit error rates to simulate
+  uint64_t framesPerPoint = 100000;    // Codewords simulated per (strategy, error rate) point
+  uint64_t maxFrameErrors = 0;         // Stop a point early after this many frame errors (0 = never)
+  unsigned threads = 0;                // Worker threads (0 = hardware concurrency)
+  uint64_t seed = 1;                   // Seed of the run; results depend only on it, not on threads
+
+  // Builds the channel simulated at one swept value for a strategy of the given
+  // code rate (default: binary symmetric Channel with that error rate)
+  std::function<std::unique_ptr<ChannelModel>(double errorRate, double codeRate)> channelFactory;
+};
+
+/**
+ * @brief Statistics collected for one (strategy, error rate) point of a sweep
+ */
+struct SweepPoint
+{
+  std::string strategy;
+  double errorRate = 0.0;
+
+  uint64_t frames = 0;          // Codewords simulated
+  uint64_t frameErrors = 0;     // Codewords whose decoded message differs from the original
+  uint64_t messageBits = 0;     // Message bits simulated
+  uint64_t bitErrors = 0;       // Message bits wrong after decoding
+  uint64_t channelBits = 0;     // Encoded bits sent through the channel
+  uint64_t channelErrors = 0;   // Bits flipped by the channel
+  uint64_t correctedErrors = 0; // Corrections reported by the decoder
+  double seconds = 0.0;         // Wall-clock time for the point
+
+  double getBitErrorRate() const;
+  double getFrameErrorRate() const;
+  double getChannelErrorRate() const;
+};
+
+/**
+ * @brief Headless Monte-Carlo engine producing BER and FER curves
+ *
+ * Each point is split into fixed-size chunks of codewords that are handed to
+ * a thread pool. Every worker owns its own Channel and strategy instance and
+ * accumulates private counters, so the workers share nothing but the chunk
+ * counter and scale with the number of cores.
+ *
+ * The random message and noise streams of a chunk are derived from
+ * (seed, point, chunk), so a sweep without an early-stop limit produces
+ * bit-identical results for any thread count.
+ */
+class SweepEngine
+{
+public:
+  /**
+   * @brief Construct a new Sweep Engine object
+   *
+   * @param config The sweep settings
+   */
+  explicit SweepEngine(const SweepConfig &config);
+
+  /**
+   * @brief Run every point of the sweep
+   *
+   * @param onPoint Optional callback invoked as each point completes
+   * @return std::vector<SweepPoint> Results in strategy-major order
+   */
+  std::vector<SweepPoint> run(const std::function<void(const SweepPoint &)> &onPoint = nullptr);
+
+  /**
+   * @brief Print the header line matching printPoint
+   *
+   * @param os The output stream to write to
+   * @param csv Whether to write comma-separated values instead of a table
+   */
+  static void printHeader(std::ostream &os, bool csv);
+
+  /**
+   * @brief Print one result line
+   *
+   * @param point The result to print
+   * @param os The output stream to write to
+   * @param csv Whether to write comma-separated values instead of a table
+   */
+  static void printPoint(const SweepPoint &point, std::ostream &os, bool csv);
+
+private:
+  SweepConfig config;
+
+  // Codewords handed to a worker at a time
+  static const uint64_t CHUNK_FRAMES = 1024;
+
+  SweepPoint runPoint(const std::string &strategy, double errorRate, uint64_t pointIndex, ThreadPool &pool);
+};
+
+#endif // SWEEP_ENGINE_H
@@ -0,0 +1,81 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads for data-parallel loops
+ *
+ * The calling thread takes part in every loop as worker 0, so a pool of size
+ * N starts N - 1 background threads.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Construct a new Thread Pool object
+   *
+   * @param threads Number of workers including the caller (0 = hardware concurrency)
+   */
+  explicit ThreadPool(unsigned threads = 0);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Get the number of workers, including the calling thread
+   *
+   * @return unsigned The number of workers
+   */
+  unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+  /**
+   * @brief Run body(index, worker) for every index in [0, count) and wait for completion
+   *
+   * Indices are handed out dynamically, so uneven work items balance across
+   * workers. The worker id is in [0, size()) and is stable for the duration of
+   * one call, which lets callers keep per-worker state without locking. The
+   * first exception thrown by the body is rethrown here.
+   *
+   * Calls from several threads run one after another. A call made from
+   * inside a body running on this pool runs inline on that worker, with its
+   * worker id, instead of waiting for the pool.
+   *
+   * @param count Number of work items
+   * @param body The work item function
+   */
+  void parallelFor(size_t count, const std::function<void(size_t index, unsigned worker)> &body);
+
+private:
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+
+  // Held for the whole of a parallelFor, so only one loop uses the workers
+  std::mutex submitMutex;
+  std::condition_variable wakeCondition;
+  std::condition_variable doneCondition;
+
+  // Current job, guarded by mutex except for the atomic counters
+  const std::function<void(size_t, unsigned)> *job;
+  size_t jobSize;
+  std::atomic<size_t> nextIndex;
+  unsigned activeWorkers;
+  unsigned long generation;
+  bool stopping;
+  std::exception_ptr firstError;
+
+  void workerLoop(unsigned worker);
+  void runItems(const std::function<void(size_t, unsigned)> &body, size_t count, unsigned worker);
+};
+
+#endif // THREAD_POOL_H
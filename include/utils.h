@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <cstdint>
+#include "bit_buffer.h"
 
 namespace Utils
 {
@@ -15,6 +17,14 @@ namespace Utils
    */
   std::vector<bool> stringToBits(const std::string &str);
 
+  /**
+   * @brief Convert a string to packed bits in a caller-provided buffer
+   *
+   * @param str The string to convert
+   * @param bits Buffer that receives the bitstream (MSB of each character first)
+   */
+  void stringToBits(const std::string &str, BitBuffer &bits);
+
   /**
    * @brief Convert a vector of boolean bits to a string
    *
@@ -23,6 +33,14 @@ namespace Utils
    */
   std::string bitsToString(const std::vector<bool> &bits);
 
+  /**
+   * @brief Convert packed bits to a string
+   *
+   * @param bits The bitstream to convert
+   * @return std::string The resulting string (empty if bits don't form complete bytes)
+   */
+  std::string bitsToString(ConstBitSpan bits);
+
   /**
    * @brief Print a bitstream as a string of 0s and 1s
    *
@@ -43,6 +61,25 @@ namespace Utils
    */
   int countDifferences(const std::vector<bool> &bits1,
                        const std::vector<bool> &bits2);
+
+  /**
+   * @brief Compare two packed bitstreams and count differences word by word
+   *
+   * @param bits1 First bitstream
+   * @param bits2 Second bitstream
+   * @return int64_t Number of bit positions that differ, or -1 if the sizes differ
+   */
+  int64_t countDifferences(ConstBitSpan bits1, ConstBitSpan bits2);
+
+  /**
+   * @brief Count differing bits over the first count positions of two bitstreams
+   *
+   * @param bits1 First bitstream
+   * @param bits2 Second bitstream
+   * @param count Number of leading bits to compare (must not exceed either size)
+   * @return size_t Number of bit positions that differ
+   */
+  size_t countDifferences(ConstBitSpan bits1, ConstBitSpan bits2, size_t count);
 }
 
 #endif // UTILS_H
@@ -0,0 +1,353 @@
+#include "../include/awgn_channel.h"
+#include "../include/cpu_features.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AWGN_HAVE_AVX2_KERNELS 1
+#endif
+
+namespace
+{
+  const float TWO_PI = 6.28318530717958647692f;
+  const float HALF_PI = 1.57079632679489661923f;
+
+  // Cephes single-precision log coefficients
+  const float LOG_P[9] = {7.0376836292E-2f, -1.1514610310E-1f, 1.1676998740E-1f,
+                          -1.2420140846E-1f, 1.4249322787E-1f, -1.6668057665E-1f,
+                          2.0000714765E-1f, -2.4999993993E-1f, 3.3333331174E-1f};
+
+  // Uniform float in (0, 1) from the top 24 bits of a 32-bit word
+  inline float toOpenUniform(uint32_t bits)
+  {
+    return (static_cast<float>(bits >> 8) + 0.5f) * (1.0f / 16777216.0f);
+  }
+
+  /*
+   * Box-Muller: r = sqrt(-2 ln u1), theta = 2 pi u2. Any uniform angle works,
+   * so theta is built as quadrant * pi/2 + a with a in [-pi/4, pi/4), which
+   * keeps the sin/cos polynomials on their accurate range. The scalar and
+   * AVX2 kernels evaluate the same polynomials.
+   */
+  void gaussianScalar(const uint32_t *random, float *out, size_t count)
+  {
+    for (size_t i = 0; i < count; i += 2)
+    {
+      float u1 = toOpenUniform(random[i]);
+      float u2 = toOpenUniform(random[i + 1]) * 4.0f;
+      float r = std::sqrt(-2.0f * std::log(u1));
+
+      int quadrant = static_cast<int>(u2);
+      float a = (u2 - quadrant - 0.5f) * HALF_PI;
+      float z = a * a;
+      float s = a + a * z * (-1.6666654611E-1f + z * (8.3321608736E-3f + z * -1.9515295891E-4f));
+      float c = 1.0f - 0.5f * z + z * z * (4.166664568298827E-2f + z * (-1.388731625493765E-3f + z * 2.443315711809948E-5f));
+
+      float cosTheta = (quadrant & 1) ? s : c;
+      float sinTheta = (quadrant & 1) ? c : s;
+      if (quadrant == 1 || quadrant == 2)
+        cosTheta = -cosTheta;
+      if (quadrant >= 2)
+        sinTheta = -sinTheta;
+
+      out[i] = r * cosTheta;
+      out[i + 1] = r * sinTheta;
+    }
+  }
+
+  void llrScalar(ConstBitSpan bits, const float *noise, float amplitude, float sigma, float gain, float *llr)
+  {
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+      float symbol = bits[i] ? -amplitude : amplitude;
+      llr[i] = gain * (symbol + sigma * noise[i]);
+    }
+  }
+
+  void quantizeScalar(const float *llr, size_t count, float scale, int8_t *out)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      float q = std::nearbyint(llr[i] * scale);
+      out[i] = static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+    }
+  }
+
+  // Pack the sign bits of 64 LLRs into a word: a negative LLR means 1
+  uint64_t hardDecisionScalar(const float *llr, int count)
+  {
+    uint64_t word = 0;
+    for (int j = 0; j < count; j++)
+    {
+      word |= static_cast<uint64_t>(std::signbit(llr[j])) << j;
+    }
+    return word;
+  }
+
+#ifdef AWGN_HAVE_AVX2_KERNELS
+  __attribute__((target("avx2,fma"))) uint64_t hardDecisionAvx2(const float *llr, int count)
+  {
+    if (count < 64)
+    {
+      return hardDecisionScalar(llr, count);
+    }
+
+    uint64_t word = 0;
+    for (int j = 0; j < 64; j += 8)
+    {
+      word |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_loadu_ps(llr + j))) << j;
+    }
+    return word;
+  }
+
+  __attribute__((target("avx2,fma"))) inline __m256 logAvx2(__m256 x)
+  {
+    // Split x into mantissa m in [sqrt(0.5), sqrt(2)) and exponent e
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                   _mm256_set1_epi32(0x3F000000)));
+    __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+    m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(small, m)), _mm256_set1_ps(1.0f));
+
+    __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_set1_ps(LOG_P[0]);
+    for (int i = 1; i < 9; i++)
+    {
+      y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(LOG_P[i]));
+    }
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(-2.12194440e-4f), y);
+    y = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, y);
+    return _mm256_fmadd_ps(e, _mm256_set1_ps(0.693359375f), _mm256_add_ps(m, y));
+  }
+
+  __attribute__((target("avx2,fma"))) inline __m256 toOpenUniformAvx2(__m256i bits)
+  {
+    __m256 value = _mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 8));
+    return _mm256_mul_ps(_mm256_add_ps(value, _mm256_set1_ps(0.5f)), _mm256_set1_ps(1.0f / 16777216.0f));
+  }
+
+  __attribute__((target("avx2,fma"))) void gaussianAvx2(const uint32_t *random, float *out, size_t count)
+  {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+      // Even words feed u1, odd words u2, matching the scalar pairing
+      __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(random + i));
+      __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(random + i + 8));
+      __m256i even = _mm256_permute4x64_epi64(
+          _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), 0x88)), 0xD8);
+      __m256i odd = _mm256_permute4x64_epi64(
+          _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(lo), _mm256_castsi256_ps(hi), 0xDD)), 0xD8);
+
+      __m256 u1 = toOpenUniformAvx2(even);
+      __m256 u2 = _mm256_mul_ps(toOpenUniformAvx2(odd), _mm256_set1_ps(4.0f));
+      __m256 r = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), logAvx2(u1)));
+
+      __m256 quadrantF = _mm256_floor_ps(u2);
+      __m256i quadrant = _mm256_cvtps_epi32(quadrantF);
+      __m256 a = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(u2, quadrantF), _mm256_set1_ps(0.5f)), _mm256_set1_ps(HALF_PI));
+      __m256 z = _mm256_mul_ps(a, a);
+
+      __m256 sp = _mm256_fmadd_ps(z, _mm256_set1_ps(-1.9515295891E-4f), _mm256_set1_ps(8.3321608736E-3f));
+      sp = _mm256_fmadd_ps(z, sp, _mm256_set1_ps(-1.6666654611E-1f));
+      __m256 s = _mm256_fmadd_ps(_mm256_mul_ps(a, z), sp, a);
+
+      __m256 cp = _mm256_fmadd_ps(z, _mm256_set1_ps(2.443315711809948E-5f), _mm256_set1_ps(-1.388731625493765E-3f));
+      cp = _mm256_fmadd_ps(z, cp, _mm256_set1_ps(4.166664568298827E-2f));
+      __m256 c = _mm256_fmadd_ps(_mm256_mul_ps(z, z), cp, _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+
+      // Rotate (c, s) by quadrant * pi/2
+      __m256 odd1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+      __m256 cosTheta = _mm256_blendv_ps(c, s, odd1);
+      __m256 sinTheta = _mm256_blendv_ps(s, c, odd1);
+      __m256i q1or2 = _mm256_or_si256(_mm256_cmpeq_epi32(quadrant, _mm256_set1_epi32(1)),
+                                      _mm256_cmpeq_epi32(quadrant, _mm256_set1_epi32(2)));
+      __m256i q2or3 = _mm256_cmpgt_epi32(quadrant, _mm256_set1_epi32(1));
+      __m256 signBit = _mm256_set1_ps(-0.0f);
+      cosTheta = _mm256_xor_ps(cosTheta, _mm256_and_ps(_mm256_castsi256_ps(q1or2), signBit));
+      sinTheta = _mm256_xor_ps(sinTheta, _mm256_and_ps(_mm256_castsi256_ps(q2or3), signBit));
+
+      // Interleave back to out[2k] = r cos, out[2k + 1] = r sin
+      __m256 x = _mm256_mul_ps(r, cosTheta);
+      __m256 y = _mm256_mul_ps(r, sinTheta);
+      __m256 first = _mm256_unpacklo_ps(x, y);
+      __m256 second = _mm256_unpackhi_ps(x, y);
+      _mm256_storeu_ps(out + i, _mm256_permute2f128_ps(first, second, 0x20));
+      _mm256_storeu_ps(out + i + 8, _mm256_permute2f128_ps(first, second, 0x31));
+    }
+
+    gaussianScalar(random + i, out + i, count - i);
+  }
+
+  __attribute__((target("avx2,fma"))) void llrAvx2(ConstBitSpan bits, const float *noise, float amplitude,
+                                                   float sigma, float gain, float *llr)
+  {
+    const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256 amp = _mm256_set1_ps(amplitude);
+    const __m256 sig = _mm256_set1_ps(sigma);
+    const __m256 g = _mm256_set1_ps(gain);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= bits.size(); i += 8)
+    {
+      // Expand 8 bits into lane masks and flip the sign of the symbols that carry a 1
+      __m256i byte = _mm256_set1_epi32(static_cast<int>(bits.getBits(i, 8)));
+      __m256i set = _mm256_cmpeq_epi32(_mm256_and_si256(byte, lanes), lanes);
+      __m256 symbol = _mm256_xor_ps(amp, _mm256_and_ps(_mm256_castsi256_ps(set), signBit));
+      __m256 y = _mm256_fmadd_ps(sig, _mm256_loadu_ps(noise + i), symbol);
+      _mm256_storeu_ps(llr + i, _mm256_mul_ps(g, y));
+    }
+
+    llrScalar(bits.subspan(i, bits.size() - i), noise + i, amplitude, sigma, gain, llr + i);
+  }
+
+  __attribute__((target("avx2,fma"))) void quantizeAvx2(const float *llr, size_t count, float scale, int8_t *out)
+  {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 lo = _mm256_set1_ps(-127.0f);
+    const __m256 hi = _mm256_set1_ps(127.0f);
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+      __m256i q[4];
+      for (int k = 0; k < 4; k++)
+      {
+        __m256 v = _mm256_mul_ps(_mm256_loadu_ps(llr + i + 8 * k), s);
+        v = _mm256_min_ps(hi, _mm256_max_ps(lo, v));
+        q[k] = _mm256_cvtps_epi32(v); // rounds to nearest even
+      }
+
+      // The packs work per 128-bit half, so restore element order afterwards
+      __m256i words = _mm256_packs_epi32(q[0], q[1]);
+      __m256i words2 = _mm256_packs_epi32(q[2], q[3]);
+      __m256i bytes = _mm256_packs_epi16(words, words2);
+      bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), bytes);
+    }
+
+    quantizeScalar(llr + i, count - i, scale, out + i);
+  }
+#endif
+}
+
+AwgnChannel::AwgnChannel(double ebN0Db, double codeRate, Modulation modulation,
+                         uint64_t seed, uint64_t stream)
+    : codeRate(codeRate), modulation(modulation), quantizationStep(0.25f), rng(seed, stream)
+{
+  setEbN0(ebN0Db);
+}
+
+std::string AwgnChannel::getName() const
+{
+  std::ostringstream name;
+  name << "AWGN(" << (modulation == Modulation::BPSK ? "BPSK" : "QPSK")
+       << ",Eb/N0=" << ebN0Db << "dB,R=" << codeRate << ")";
+  return name.str();
+}
+
+std::unique_ptr<ChannelModel> AwgnChannel::clone() const
+{
+  return std::make_unique<AwgnChannel>(*this);
+}
+
+void AwgnChannel::reseed(uint64_t seed, uint64_t stream)
+{
+  rng.reseed(seed, stream);
+}
+
+void AwgnChannel::setEbN0(double newEbN0Db)
+{
+  ebN0Db = newEbN0Db;
+
+  // Unit symbol energy. Each coded bit carries R * Eb, and Gray-mapped QPSK
+  // splits the symbol energy over two bits, one per dimension.
+  double ebN0 = std::pow(10.0, ebN0Db / 10.0);
+  double bitsPerSymbol = modulation == Modulation::BPSK ? 1.0 : 2.0;
+  double n0 = 1.0 / (bitsPerSymbol * codeRate * ebN0);
+
+  amplitude = static_cast<float>(std::sqrt(1.0 / bitsPerSymbol));
+  sigma = static_cast<float>(std::sqrt(n0 / 2.0));
+  llrGain = 2.0f * amplitude / (sigma * sigma);
+}
+
+double AwgnChannel::getErrorRate() const
+{
+  double ebN0 = std::pow(10.0, ebN0Db / 10.0);
+  return 0.5 * std::erfc(std::sqrt(codeRate * ebN0));
+}
+
+void AwgnChannel::generateNoise(size_t count)
+{
+  // Two 32-bit uniforms per sample pair; round up to whole pairs of words
+  size_t words = (count + 1) / 2 + 1;
+  randomWords.resize(words);
+  rng.fill(randomWords.data(), words);
+  noise.resize(2 * words);
+
+  const uint32_t *random = reinterpret_cast<const uint32_t *>(randomWords.data());
+#ifdef AWGN_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2())
+  {
+    gaussianAvx2(random, noise.data(), 2 * words);
+    return;
+  }
+#endif
+  gaussianScalar(random, noise.data(), 2 * words);
+}
+
+void AwgnChannel::transmit(ConstBitSpan bits, std::vector<float> &llr)
+{
+  generateNoise(bits.size());
+  llr.resize(bits.size());
+
+#ifdef AWGN_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2())
+  {
+    llrAvx2(bits, noise.data(), amplitude, sigma, llrGain, llr.data());
+    return;
+  }
+#endif
+  llrScalar(bits, noise.data(), amplitude, sigma, llrGain, llr.data());
+}
+
+void AwgnChannel::transmit(ConstBitSpan bits, std::vector<int8_t> &llr)
+{
+  transmit(bits, llrBuffer);
+  llr.resize(bits.size());
+
+#ifdef AWGN_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2())
+  {
+    quantizeAvx2(llrBuffer.data(), llrBuffer.size(), 1.0f / quantizationStep, llr.data());
+    return;
+  }
+#endif
+  quantizeScalar(llrBuffer.data(), llrBuffer.size(), 1.0f / quantizationStep, llr.data());
+}
+
+void AwgnChannel::transmit(BitSpan bits)
+{
+  transmit(ConstBitSpan(bits), llrBuffer);
+
+  uint64_t (*hardDecision)(const float *, int) = hardDecisionScalar;
+#ifdef AWGN_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2())
+  {
+    hardDecision = hardDecisionAvx2;
+  }
+#endif
+
+  for (size_t i = 0; i < bits.size(); i += 64)
+  {
+    int count = static_cast<int>(std::min<size_t>(64, bits.size() - i));
+    bits.setBits(i, count, hardDecision(llrBuffer.data() + i, count));
+  }
+}
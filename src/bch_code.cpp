@@ -1,394 +1,1099 @@
 #include "../include/bch_code.h"
-#include <cmath>
+#include "../include/cpu_features.h"
 #include <algorithm>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 
-BCHCode::BCHCode(int m, int t) : m(m), t(t)
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BCH_HAVE_AVX2_KERNELS 1
+#define BCH_HAVE_CLMUL_KERNELS 1
+#endif
+
+namespace
 {
-  // Compute code parameters
-  n = (1 << m) - 1; // Codeword length
-  k = n - m * t;    // Message length
+  // Codewords whose syndromes are evaluated side by side
+  const size_t LANE_GROUP = CodewordBatch::LANE_GROUP;
 
-  // Initialize tables
-  initTables();
+  // Dirty codewords in a group needed for the lane syndrome kernel to pay off
+  const size_t SYNDROME_LANE_MIN = 4;
 
-  // Generate generator polynomial
-  generatePolynomial();
-}
+  // Largest lane syndrome table kept per code
+  const size_t MAX_LANE_TABLE_BYTES = 1 << 16;
 
-void BCHCode::initTables()
-{
-  // Initialize tables for Galois field operations
-  int fieldSize = 1 << m;
-  alphaTo.resize(fieldSize, 0);
-  indexOf.resize(fieldSize, 0);
-
-  // Choose primitive polynomial based on m
-  int p = 0;
-  switch (m)
-  {
-  case 2:
-    p = 0x7;
-    break; // x^2 + x + 1
-  case 3:
-    p = 0xB;
-    break; // x^3 + x + 1
-  case 4:
-    p = 0x13;
-    break; // x^4 + x + 1
-  case 5:
-    p = 0x25;
-    break; // x^5 + x^2 + 1
-  case 6:
-    p = 0x43;
-    break; // x^6 + x + 1
-  case 7:
-    p = 0x89;
-    break; // x^7 + x^3 + 1
-  case 8:
-    p = 0x11D;
-    break; // x^8 + x^4 + x^3 + x^2 + 1
-  default:
-    throw std::invalid_argument("Unsupported field size");
+  // Record every error pattern of up to `remaining` more bits from `first`
+  // on, XORing the remainders of its bits
+  void addErrorPatterns(const std::vector<uint32_t> &unitRemainders, int first, int remaining, uint32_t remainder,
+                        uint64_t pattern, std::vector<uint64_t> &patterns)
+  {
+    for (int p = first; p < static_cast<int>(unitRemainders.size()); p++)
+    {
+      uint32_t nextRemainder = remainder ^ unitRemainders[p];
+      uint64_t nextPattern = pattern | (uint64_t(1) << p);
+      patterns[nextRemainder] = nextPattern;
+      if (remaining > 1)
+      {
+        addErrorPatterns(unitRemainders, p + 1, remaining - 1, nextRemainder, nextPattern, patterns);
+      }
+    }
   }
 
-  // Generate field elements using the primitive polynomial
-  int x = 1;
-  alphaTo[m] = 0;
-
-  for (int i = 0; i < m; i++)
+#ifdef BCH_HAVE_CLMUL_KERNELS
+  /*
+   * Fold the first chunks * 128 * Pairs message bits into a residue of
+   * 128 * Pairs bits with the same remainder modulo g(x), held as pairs of
+   * words. The bits are reflected (the first bit is the highest degree), so
+   * each carry-less product of a residue word and a constant comes out
+   * multiplied by x, which the constants make up for.
+   */
+  template <int Pairs>
+  __attribute__((target("pclmul"))) void foldClmul(ConstBitSpan message, size_t chunks, const uint64_t *constants,
+                                                   uint64_t *residue)
   {
-    alphaTo[i] = x;
-    indexOf[alphaTo[i]] = i;
+    const uint64_t *aligned = message.offset() == 0 ? message.words() : nullptr;
+    auto load = [&](size_t word)
+    {
+      if (aligned != nullptr)
+      {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(aligned + word));
+      }
+      return _mm_set_epi64x(static_cast<long long>(message.getBits(64 * (word + 1), 64)),
+                            static_cast<long long>(message.getBits(64 * word, 64)));
+    };
 
-    x <<= 1;
-    if (x & (1 << m))
+    __m128i current[Pairs];
+    for (int q = 0; q < Pairs; q++)
     {
-      x ^= p;
+      current[q] = load(2 * q);
     }
-  }
 
-  indexOf[0] = -1; // Invalid index for 0
+    for (size_t c = 1; c < chunks; c++)
+    {
+      __m128i next[Pairs];
+      for (int q = 0; q < Pairs; q++)
+      {
+        next[q] = load(2 * (c * Pairs + q));
+      }
+
+      // Every residue word moves foldBits up and becomes word * constant;
+      // the products for residue words s and s + 1 are summed first
+      for (int s = 0; s + 1 < 2 * Pairs; s++)
+      {
+        __m128i sum = _mm_setzero_si128();
+        for (int q = 0; q < Pairs; q++)
+        {
+          __m128i constant = _mm_loadu_si128(reinterpret_cast<const __m128i *>(constants + 2 * (s * Pairs + q)));
+          sum = _mm_xor_si128(sum, _mm_clmulepi64_si128(current[q], constant, 0x00));
+          sum = _mm_xor_si128(sum, _mm_clmulepi64_si128(current[q], constant, 0x11));
+        }
+        if (s % 2 == 0)
+        {
+          next[s / 2] = _mm_xor_si128(next[s / 2], sum);
+        }
+        else
+        {
+          next[s / 2] = _mm_xor_si128(next[s / 2], _mm_slli_si128(sum, 8));
+          next[s / 2 + 1] = _mm_xor_si128(next[s / 2 + 1], _mm_srli_si128(sum, 8));
+        }
+      }
+
+      for (int q = 0; q < Pairs; q++)
+      {
+        current[q] = next[q];
+      }
+    }
+
+    for (int q = 0; q < Pairs; q++)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(residue + 2 * q), current[q]);
+    }
+  }
+#endif
 
-  // Continue generating field elements
-  for (int i = m; i < n; i++)
+#ifdef BCH_HAVE_AVX2_KERNELS
+  /*
+   * Chien search over 32 consecutive bits per step. The values of each
+   * locator term at those bits are kept as a plane of low bytes and a plane
+   * of high bytes. Moving 32 bits on multiplies every value by the same
+   * constant, a linear map that is applied with one byte shuffle per
+   * nibble of the value and byte of the product.
+   */
+  __attribute__((target("avx2"))) int chienAvx2(uint16_t constant, uint8_t *planes, const uint8_t *tables,
+                                                int terms, int n, int maxRoots, int *positions)
   {
-    if (alphaTo[i - 1] >= (1 << (m - 1)))
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i constantLow = _mm256_set1_epi8(static_cast<char>(constant & 0xFF));
+    const __m256i constantHigh = _mm256_set1_epi8(static_cast<char>(constant >> 8));
+
+    int found = 0;
+    for (int p = 0; p < n; p += 32)
     {
-      alphaTo[i] = (alphaTo[i - 1] << 1) ^ p;
+      __m256i sumLow = constantLow;
+      __m256i sumHigh = constantHigh;
+      for (int c = 0; c < terms; c++)
+      {
+        __m256i *plane = reinterpret_cast<__m256i *>(planes + 64 * c);
+        const __m256i *table = reinterpret_cast<const __m256i *>(tables + 256 * c);
+        __m256i low = _mm256_loadu_si256(plane);
+        __m256i high = _mm256_loadu_si256(plane + 1);
+        sumLow = _mm256_xor_si256(sumLow, low);
+        sumHigh = _mm256_xor_si256(sumHigh, high);
+
+        __m256i n0 = _mm256_and_si256(low, nibble);
+        __m256i n1 = _mm256_and_si256(_mm256_srli_epi16(low, 4), nibble);
+        __m256i n2 = _mm256_and_si256(high, nibble);
+        __m256i n3 = _mm256_and_si256(_mm256_srli_epi16(high, 4), nibble);
+        __m256i productLow = _mm256_xor_si256(
+            _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_loadu_si256(table), n0),
+                             _mm256_shuffle_epi8(_mm256_loadu_si256(table + 1), n1)),
+            _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_loadu_si256(table + 2), n2),
+                             _mm256_shuffle_epi8(_mm256_loadu_si256(table + 3), n3)));
+        __m256i productHigh = _mm256_xor_si256(
+            _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_loadu_si256(table + 4), n0),
+                             _mm256_shuffle_epi8(_mm256_loadu_si256(table + 5), n1)),
+            _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_loadu_si256(table + 6), n2),
+                             _mm256_shuffle_epi8(_mm256_loadu_si256(table + 7), n3)));
+        _mm256_storeu_si256(plane, productLow);
+        _mm256_storeu_si256(plane + 1, productHigh);
+      }
+
+      __m256i zero = _mm256_cmpeq_epi8(_mm256_or_si256(sumLow, sumHigh), _mm256_setzero_si256());
+      unsigned roots = static_cast<unsigned>(_mm256_movemask_epi8(zero));
+      while (roots != 0)
+      {
+        int position = p + __builtin_ctz(roots);
+        roots &= roots - 1;
+        if (position >= n)
+        {
+          break;
+        }
+        positions[found++] = position;
+        if (found == maxRoots)
+        {
+          return found;
+        }
+      }
     }
-    else
+    return found;
+  }
+
+  /*
+   * Odd syndromes of 32 remainders at once, one codeword per byte lane.
+   * Each remainder byte adds its share of every syndrome through two nibble
+   * shuffles per syndrome byte; the high bytes are skipped up to GF(2^8).
+   */
+  __attribute__((target("avx2"))) void syndromesLanesAvx2(const uint8_t *remainders, uint8_t *syndromes,
+                                                          size_t stride, int bytes, int count, bool wide,
+                                                          const uint8_t *tables)
+  {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    for (int s = 0; s < count; s++)
     {
-      alphaTo[i] = alphaTo[i - 1] << 1;
+      __m256i low = _mm256_setzero_si256();
+      __m256i high = _mm256_setzero_si256();
+      for (int q = 0; q < bytes; q++)
+      {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(remainders + q * stride));
+        __m256i n0 = _mm256_and_si256(value, nibble);
+        __m256i n1 = _mm256_and_si256(_mm256_srli_epi16(value, 4), nibble);
+        const __m128i *table = reinterpret_cast<const __m128i *>(tables + 64 * (static_cast<size_t>(s) * bytes + q));
+        low = _mm256_xor_si256(low, _mm256_xor_si256(
+                                        _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(table)), n0),
+                                        _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(table + 1)), n1)));
+        if (wide)
+        {
+          high = _mm256_xor_si256(high, _mm256_xor_si256(
+                                            _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(table + 2)), n0),
+                                            _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(table + 3)), n1)));
+        }
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(syndromes + 2 * s * stride), low);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(syndromes + (2 * s + 1) * stride), high);
     }
-    indexOf[alphaTo[i]] = i;
   }
+#endif
+}
+
+BCHCode::BCHCode(int m, int t, int shortening, int polynomial) : m(m), t(t)
+{
+  // Galois field tables, built at compile time
+  if (polynomial == 0)
+  {
+    polynomial = GaloisField::defaultPolynomial(m);
+  }
+  if (polynomial == 0)
+  {
+    throw std::invalid_argument("Unsupported field size");
+  }
+  field = &GaloisField::get(m, polynomial);
+
+  if (t < 1 || 2 * t >= field->order)
+  {
+    throw std::invalid_argument("Error correction capability out of range");
+  }
+
+  // Generate generator polynomial; its degree is the number of parity bits
+  generatePolynomial();
+  int parity = static_cast<int>(g.size()) - 1;
+  if (shortening < 0 || parity + shortening >= field->order)
+  {
+    throw std::invalid_argument("Shortening leaves no message bits");
+  }
+
+  // Compute code parameters
+  n = field->order - shortening; // Codeword length
+  k = n - parity;                // Message length
+
+  initEncoder();
+  initSyndromes();
 }
 
 void BCHCode::generatePolynomial()
 {
-  // Initialize generator polynomial g(x) = 1
-  g.resize(n - k + 1, 0);
-  g[0] = 1;
+  // g(x) is the least common multiple of the minimal polynomials of
+  // alpha^1 .. alpha^2t: the product of (x - alpha^c) over every exponent c
+  // in their cyclotomic cosets {i, 2i, 4i, ..} mod 2^m - 1
+  const int order = field->order;
+  std::vector<bool> used(order, false);
+  std::vector<uint16_t> product(1, 1); // Lowest degree first
+
+  for (int i = 1; i <= 2 * t; i++)
+  {
+    if (used[i])
+    {
+      continue;
+    }
+    int c = i;
+    do
+    {
+      used[c] = true;
+      uint16_t root = field->exp[c];
+      product.push_back(0);
+      for (size_t j = product.size() - 1; j > 0; j--)
+      {
+        product[j] = product[j - 1] ^ field->mul(product[j], root);
+      }
+      product[0] = field->mul(product[0], root);
+      c = c * 2 % order;
+    } while (c != i);
+  }
+
+  // The coefficients are binary
+  g.assign(product.rbegin(), product.rend());
+}
+
+void BCHCode::initEncoder()
+{
+  const int r = n - k;
+  parityWords = (r + 63) / 64;
 
-  // Find minimal polynomials and multiply them
-  for (int i = 1; i <= 2 * t; i += 2)
+  // Division by g: a message bit at degree d removes x^(d - r) * g(x), whose
+  // coefficient of x^(r - j) is g[j]
+  bitRow.assign(parityWords, 0);
+  for (int j = 1; j <= r; j++)
   {
-    // Minimal polynomial for a^i (assuming a^i and a^(i+1) are conjugates)
-    std::vector<uint16_t> mp(m + 1, 0);
-    mp[0] = 1;
+    if (g[j] == 1)
+    {
+      bitRow[(j - 1) / 64] |= uint64_t(1) << ((j - 1) % 64);
+    }
+  }
 
-    // Compute minimal polynomial
-    int root = i;
-    for (int j = 1; j <= m; j++)
+  // powers[d] = x^(r + d) mod g(x); multiplying by x moves each bit one
+  // place towards bit 0 and feeds bit 0 back through bitRow
+  const int powerCount = r >= 64 ? 64 : 8;
+  std::vector<uint64_t> powers(static_cast<size_t>(powerCount) * parityWords);
+  std::copy(bitRow.begin(), bitRow.end(), powers.begin());
+  for (int d = 1; d < powerCount; d++)
+  {
+    const uint64_t *previous = &powers[(d - 1) * parityWords];
+    uint64_t *current = &powers[d * parityWords];
+    for (int w = 0; w < parityWords; w++)
+    {
+      current[w] = (previous[w] >> 1) | (w + 1 < parityWords ? previous[w + 1] << 63 : 0);
+    }
+    if (previous[0] & 1)
     {
-      mp[j] = 1;
-      for (int l = j - 1; l > 0; l--)
+      for (int w = 0; w < parityWords; w++)
       {
-        if (mp[l] != 0)
-        {
-          mp[l] = mp[l - 1] ^ alphaTo[(indexOf[mp[l]] + root) % n];
-        }
-        else
-        {
-          mp[l] = mp[l - 1];
-        }
+        current[w] ^= bitRow[w];
       }
-      mp[0] = alphaTo[(indexOf[mp[0]] + root) % n];
-      root = (root * 2) % n;
     }
+  }
 
-    // Multiply generator polynomial by minimal polynomial
-    std::vector<uint16_t> tmp(n - k + 1, 0);
-    for (size_t j = 0; j < g.size(); j++)
+  // Bit b of a byte entering the register is the coefficient of x^(r + 7 - b)
+  auto buildRows = [&](uint64_t *rows, int shift)
+  {
+    for (int v = 0; v < 256; v++)
     {
-      for (size_t l = 0; l < mp.size(); l++)
+      uint64_t *row = rows + v * parityWords;
+      std::fill(row, row + parityWords, 0);
+      for (int b = 0; b < 8; b++)
       {
-        if (j + l < tmp.size())
+        if ((v >> b) & 1)
         {
-          if (g[j] != 0 && mp[l] != 0)
+          const uint64_t *power = &powers[(shift + 7 - b) * parityWords];
+          for (int w = 0; w < parityWords; w++)
           {
-            tmp[j + l] ^= alphaTo[(indexOf[g[j]] + indexOf[mp[l]]) % n];
+            row[w] ^= power[w];
           }
         }
       }
     }
-    g = tmp;
+  };
+
+  byteRows.resize(256 * static_cast<size_t>(parityWords));
+  buildRows(byteRows.data(), 0);
+
+  // Byte j of a 64-bit chunk is followed by 7 - j more bytes
+  wordRows.clear();
+  if (r >= 64)
+  {
+    wordRows.resize(8 * 256 * static_cast<size_t>(parityWords));
+    for (int j = 0; j < 8; j++)
+    {
+      buildRows(&wordRows[j * 256 * static_cast<size_t>(parityWords)], 8 * (7 - j));
+    }
+  }
+
+  parityRegister.resize(parityWords);
+
+  // Folding constants: x^e mod g(x) is the register after feeding a one
+  // followed by e - (n - k) zeros. A word of the residue is a 64-bit
+  // polynomial at degree foldBits - 64 - 64j; foldBits further up it is
+  // congruent to the word times x^(2 * foldBits - 64 - 64j) mod g(x), of
+  // degree < n - k + 64 <= foldBits, and the carry-less product adds one x.
+  // The residue is a whole number of word pairs, at most four.
+  foldWords = 2 * ((r + 64 + 127) / 128);
+  foldBits = 64 * foldWords;
+  foldConstants.clear();
+  if (foldWords > 8)
+  {
+    return;
+  }
+
+  std::vector<uint64_t> constant(foldWords - 1);
+  foldConstants.assign(static_cast<size_t>(foldWords) * (foldWords - 1), 0);
+  foldBuffer.resize(foldWords);
+  BitBuffer power;
+  for (int j = 0; j < foldWords; j++)
+  {
+    int exponent = 2 * foldBits - 65 - 64 * j;
+    power.reset(exponent - r + 1);
+    power.flip(0);
+    std::fill(parityRegister.begin(), parityRegister.end(), 0);
+    feedRegister(power);
+
+    // Degree d of the constant goes to bit foldBits - 65 - d of its words
+    std::fill(constant.begin(), constant.end(), 0);
+    BitSpan(constant.data(), 0, foldBits - 64)
+        .subspan(foldBits - 64 - r, r)
+        .copyFrom(ConstBitSpan(parityRegister.data(), 0, r));
+
+    // Word s of constant j is lane j % 2 of the pair (s, j / 2)
+    for (int s = 0; s + 1 < foldWords; s++)
+    {
+      foldConstants[2 * (s * (foldWords / 2) + j / 2) + j % 2] = constant[s];
+    }
+  }
+}
+
+void BCHCode::encode(ConstBitSpan input, BitBuffer &output)
+{
+  // The message (padded or truncated to k bits) takes the higher-order
+  // positions of the codeword
+  output.reset(n);
+  output.span().subspan(0, std::min<size_t>(input.size(), k)).copyFrom(input.subspan(0, std::min<size_t>(input.size(), k)));
+  encodeParity(output.view().subspan(0, k), output.span().subspan(k, n - k));
+}
+
+void BCHCode::encodeBatch(ConstBitSpan messages, BitSpan codewords)
+{
+  size_t count = batchSize(messages.size(), codewords.size());
+  for (size_t c = 0; c < count; c++)
+  {
+    ConstBitSpan message = messages.subspan(c * k, k);
+    BitSpan codeword = codewords.subspan(c * n, n);
+    codeword.subspan(0, k).copyFrom(message);
+    encodeParity(message, codeword.subspan(k, n - k));
   }
 }
 
-std::vector<bool> BCHCode::encode(const std::vector<bool> &input)
+void BCHCode::encodeParity(ConstBitSpan message, BitSpan parity)
 {
-  // Pad or truncate input to k bits
-  std::vector<bool> message(k);
-  for (int i = 0; i < k && i < static_cast<int>(input.size()); i++)
+  // Short codes: the parity is the remainder of the message bits alone,
+  // one table entry per byte
+  if (useDecodeTable())
+  {
+    const DecodeTable &table = getDecodeTable();
+    uint64_t word = message.getBits(0, k);
+    uint32_t remainder = 0;
+    for (int b = 0; 8 * b < k; b++)
+    {
+      remainder ^= table.byteRemainders[b * 256 + ((word >> (8 * b)) & 0xFF)];
+    }
+    parity.setBits(0, n - k, remainder);
+    return;
+  }
+
+  divideMessage(message);
+
+  // Copy the remainder to the parity positions
+  for (int w = 0; w < parityWords; w++)
   {
-    message[i] = input[i];
+    int count = std::min(64, n - k - 64 * w);
+    parity.setBits(64 * static_cast<size_t>(w), count, parityRegister[w]);
   }
+}
 
-  // Create codeword vector
-  std::vector<bool> codeword(n);
+void BCHCode::divideMessage(ConstBitSpan message)
+{
+  std::fill(parityRegister.begin(), parityRegister.end(), 0);
+  size_t done = 0;
 
-  // Copy message bits to higher-order positions
-  for (int i = 0; i < k; i++)
+#ifdef BCH_HAVE_CLMUL_KERNELS
+  // The residue takes as long to feed through the LFSR as foldBits message
+  // bits, so fold only messages that are several chunks long
+  if (!foldConstants.empty() && message.size() >= 4 * static_cast<size_t>(foldBits) && CpuFeatures::hasPclmul())
   {
-    codeword[i] = message[i];
+    size_t chunks = message.size() / foldBits;
+    switch (foldWords)
+    {
+    case 2:
+      foldClmul<1>(message, chunks, foldConstants.data(), foldBuffer.data());
+      break;
+    case 4:
+      foldClmul<2>(message, chunks, foldConstants.data(), foldBuffer.data());
+      break;
+    case 6:
+      foldClmul<3>(message, chunks, foldConstants.data(), foldBuffer.data());
+      break;
+    default:
+      foldClmul<4>(message, chunks, foldConstants.data(), foldBuffer.data());
+      break;
+    }
+    feedRegister(ConstBitSpan(foldBuffer.data(), 0, foldBits));
+    done = chunks * foldBits;
   }
+#endif
+
+  feedRegister(message.subspan(done, message.size() - done));
+}
 
-  // Compute redundant bits using generator polynomial
-  std::vector<bool> temp = codeword; // Make a copy to work with
+void BCHCode::feedRegister(ConstBitSpan message)
+{
+  // Divide the message by g(x) like a CRC: the register holds the running
+  // remainder and each step feeds 64, 8 or 1 message bits through the tables
+  uint64_t *reg = parityRegister.data();
+  const int words = parityWords;
+  size_t i = 0;
 
-  for (int i = 0; i < k; i++)
+  if (!wordRows.empty())
   {
-    if (temp[i])
+    for (; i + 64 <= message.size(); i += 64)
     {
-      for (int j = 0; j < static_cast<int>(g.size()); j++)
+      uint64_t feedback = reg[0] ^ message.getBits(i, 64);
+      for (int w = 0; w + 1 < words; w++)
       {
-        if (g[j] != 0 && i + j < n)
+        reg[w] = reg[w + 1];
+      }
+      reg[words - 1] = 0;
+      for (int j = 0; j < 8; j++)
+      {
+        const uint64_t *row = &wordRows[(j * 256 + ((feedback >> (8 * j)) & 0xFF)) * static_cast<size_t>(words)];
+        for (int w = 0; w < words; w++)
         {
-          // XOR operation (^ doesn't work directly on vector<bool> references)
-          temp[i + j] = temp[i + j] != (g[j] == 1);
+          reg[w] ^= row[w];
         }
       }
     }
   }
 
-  // Copy parity bits to codeword
-  for (int i = k; i < n; i++)
+  if (n - k >= 8)
   {
-    codeword[i] = temp[i];
+    for (; i + 8 <= message.size(); i += 8)
+    {
+      uint64_t feedback = (reg[0] ^ message.getBits(i, 8)) & 0xFF;
+      const uint64_t *row = &byteRows[feedback * words];
+      for (int w = 0; w + 1 < words; w++)
+      {
+        reg[w] = ((reg[w] >> 8) | (reg[w + 1] << 56)) ^ row[w];
+      }
+      reg[words - 1] = (reg[words - 1] >> 8) ^ row[words - 1];
+    }
   }
 
-  return codeword;
+  for (; i < message.size(); i++)
+  {
+    bool feedback = (reg[0] & 1) != message[i];
+    for (int w = 0; w + 1 < words; w++)
+    {
+      reg[w] = (reg[w] >> 1) | (reg[w + 1] << 63);
+    }
+    reg[words - 1] >>= 1;
+    if (feedback)
+    {
+      for (int w = 0; w < words; w++)
+      {
+        reg[w] ^= bitRow[w];
+      }
+    }
+  }
 }
 
-std::vector<uint16_t> BCHCode::computeSyndrome(const std::vector<bool> &received)
+void BCHCode::initSyndromes()
 {
-  // Compute syndromes
-  std::vector<uint16_t> syndrome(2 * t, 0);
+  // The received bits form R(x) = sum r_i x^(n-1-i), as in the encoder
+  // register, and S_i = R(alpha^i). Since g(x) is a multiple of the minimal
+  // polynomial M(x) of alpha^i, R(x), R(x) mod g(x) and its remainder
+  // modulo M(x) all agree at alpha^i.
+  const int order = field->order;
+  minimalPolynomials.clear();
+  syndromePolynomial.clear();
+  syndromeTables.assign(static_cast<size_t>(t) * 512, 0);
 
-  for (int i = 0; i < 2 * t; i++)
+  for (int i = 1; i < 2 * t; i += 2)
   {
-    uint16_t syn = 0;
-    for (int j = 0; j < n; j++)
+    // M(x) = prod (x - alpha^c) over the coset of i, lowest degree first
+    std::vector<uint16_t> poly(1, 1);
+    int c = i;
+    do
+    {
+      uint16_t root = field->exp[c];
+      poly.push_back(0);
+      for (size_t j = poly.size() - 1; j > 0; j--)
+      {
+        poly[j] = poly[j - 1] ^ field->mul(poly[j], root);
+      }
+      poly[0] = field->mul(poly[0], root);
+      c = c * 2 % order;
+    } while (c != i);
+
+    // x^degree mod M(x), in the register layout
+    MinimalPolynomial minimal;
+    minimal.degree = static_cast<int>(poly.size()) - 1;
+    minimal.bitRow = 0;
+    for (int j = 1; j <= minimal.degree; j++)
     {
-      if (received[j])
+      if (poly[minimal.degree - j] != 0)
       {
-        if (j == 0)
+        minimal.bitRow |= uint32_t(1) << (j - 1);
+      }
+    }
+
+    // Odd syndromes with conjugate roots share the polynomial
+    int index = 0;
+    while (index < static_cast<int>(minimalPolynomials.size()) &&
+           (minimalPolynomials[index].degree != minimal.degree || minimalPolynomials[index].bitRow != minimal.bitRow))
+    {
+      index++;
+    }
+    syndromePolynomial.push_back(index);
+
+    if (index == static_cast<int>(minimalPolynomials.size()))
+    {
+      // powers[e] = x^(degree + e) mod M(x); byte bit b has degree 7 - b
+      uint32_t powers[8];
+      powers[0] = minimal.bitRow;
+      for (int e = 1; e < 8; e++)
+      {
+        powers[e] = (powers[e - 1] >> 1) ^ ((powers[e - 1] & 1) ? minimal.bitRow : 0);
+      }
+      minimal.byteRows.assign(256, 0);
+      for (int v = 0; v < 256; v++)
+      {
+        for (int b = 0; b < 8; b++)
         {
-          syn ^= 1;
+          if ((v >> b) & 1)
+          {
+            minimal.byteRows[v] ^= powers[7 - b];
+          }
         }
-        else
+      }
+      minimalPolynomials.push_back(minimal);
+    }
+
+    // The reduction yields Q(x) = (R(x) x^degree) mod M(x), so with bit q of
+    // Q at degree - 1 - q, S_i = sum of Q_q alpha^(-i(q + 1))
+    uint16_t *tables = &syndromeTables[static_cast<size_t>(i / 2) * 512];
+    for (int v = 0; v < 256; v++)
+    {
+      for (int b = 0; b < 8; b++)
+      {
+        if ((v >> b) & 1)
+        {
+          tables[v] ^= field->exp[order - static_cast<int64_t>(i) * (b + 1) % order];
+          tables[256 + v] ^= field->exp[order - static_cast<int64_t>(i) * (b + 9) % order];
+        }
+      }
+    }
+  }
+
+  minimalRemainders.resize(minimalPolynomials.size());
+  syndromeBuffer.resize(2 * t);
+
+  // Remainder bit p is the coefficient of x^(r-1-p), so byte q adds
+  // alpha^(i(r-1-p)) to S_i for each of its set bits p = 8q + b < r
+  const int r = n - k;
+  remainderBytes = (r + 7) / 8;
+  laneSyndromeTables.clear();
+  if (static_cast<size_t>(t) * remainderBytes * 64 <= MAX_LANE_TABLE_BYTES)
+  {
+    laneSyndromeTables.assign(static_cast<size_t>(t) * remainderBytes * 64, 0);
+    for (int s = 0; s < t; s++)
+    {
+      const int i = 2 * s + 1;
+      for (int q = 0; q < remainderBytes; q++)
+      {
+        uint8_t *tables = &laneSyndromeTables[64 * (static_cast<size_t>(s) * remainderBytes + q)];
+        for (int b = 0; b < 8 && 8 * q + b < r; b++)
         {
-          int idx = (i + 1) * j % n;
-          syn ^= alphaTo[idx];
+          uint16_t share = field->exp[static_cast<int64_t>(i) * (r - 1 - 8 * q - b) % order];
+          int half = b / 4;
+          for (int x = 0; x < 16; x++)
+          {
+            if ((x >> (b % 4)) & 1)
+            {
+              tables[16 * half + x] ^= static_cast<uint8_t>(share);
+              tables[32 + 16 * half + x] ^= static_cast<uint8_t>(share >> 8);
+            }
+          }
         }
       }
     }
-    syndrome[i] = syn;
+    laneRemainders.resize(LANE_GROUP, remainderBytes);
+    laneSyndromes.resize(LANE_GROUP, 2 * t);
   }
 
-  return syndrome;
+  // An uncorrectable word may push the locator degree past t before the
+  // final check
+  locator.resize(2 * t + 1);
+  previous.resize(2 * t + 1);
+  saved.resize(2 * t + 1);
+  termLog.resize(2 * t + 1);
+  termDegree.resize(2 * t + 1);
+  chienPlanes.resize(64 * (2 * t + 1));
+  chienTables.resize(256 * (2 * t + 1));
+  positions.resize(2 * t + 1);
 }
 
-std::vector<int> BCHCode::findErrorLocations(const std::vector<uint16_t> &syndrome)
+bool BCHCode::computeRemainder(ConstBitSpan received)
 {
-  // Berlekamp-Massey algorithm with improved error correction
-  std::vector<uint16_t> elp(t + 2, 0); // Error locator polynomial
-  std::vector<uint16_t> d(t + 2, 0);   // Discrepancy
-  std::vector<uint16_t> l(t + 2, 0);   // Current error locator length
-  std::vector<uint16_t> b(t + 2, 0);   // Correction polynomial
-  std::vector<int> errorLocations;
+  // r(x) mod g(x) is the parity of the received message XOR the received parity
+  divideMessage(received.subspan(0, k));
+  uint64_t any = 0;
+  for (int w = 0; w < parityWords; w++)
+  {
+    int count = std::min(64, n - k - 64 * w);
+    parityRegister[w] ^= received.getBits(k + 64 * static_cast<size_t>(w), count);
+    any |= parityRegister[w];
+  }
+  return any != 0;
+}
 
-  elp[0] = 1; // Initialize error locator polynomial
-  elp[1] = syndrome[0];
+void BCHCode::computeSyndromes(std::vector<uint16_t> &syndrome)
+{
+  // Reduce the n - k remainder bits modulo each minimal polynomial, a byte
+  // at a time, instead of walking all n received bits per syndrome
+  const int r = n - k;
+  for (size_t p = 0; p < minimalPolynomials.size(); p++)
+  {
+    const MinimalPolynomial &minimal = minimalPolynomials[p];
+    uint32_t reg = 0;
+    int q = 0;
+    for (; q + 8 <= r; q += 8)
+    {
+      uint32_t byte = static_cast<uint32_t>(parityRegister[q / 64] >> (q % 64)) & 0xFF;
+      reg = minimal.byteRows[(reg ^ byte) & 0xFF] ^ (reg >> 8);
+    }
+    for (; q < r; q++)
+    {
+      uint32_t bit = static_cast<uint32_t>(parityRegister[q / 64] >> (q % 64)) & 1;
+      bool feedback = ((reg ^ bit) & 1) != 0;
+      reg >>= 1;
+      if (feedback)
+      {
+        reg ^= minimal.bitRow;
+      }
+    }
+    minimalRemainders[p] = reg;
+  }
 
-  l[0] = 0;
-  l[1] = 0;
+  // Odd syndromes from two table lookups, even ones by squaring:
+  // S_2i = r(alpha^2i) = r(alpha^i)^2 for a binary r(x)
+  for (int i = 1; i <= 2 * t; i++)
+  {
+    if (i % 2 == 1)
+    {
+      uint32_t reg = minimalRemainders[syndromePolynomial[i / 2]];
+      const uint16_t *tables = &syndromeTables[static_cast<size_t>(i / 2) * 512];
+      syndrome[i - 1] = tables[reg & 0xFF] ^ tables[256 + ((reg >> 8) & 0xFF)];
+    }
+    else
+    {
+      syndrome[i - 1] = field->mul(syndrome[i / 2 - 1], syndrome[i / 2 - 1]);
+    }
+  }
+}
 
-  if (syndrome[0] != 0)
+void BCHCode::laneSyndrome(size_t lane, std::vector<uint16_t> &syndrome) const
+{
+  for (int i = 1; i <= 2 * t; i++)
   {
-    l[1] = 1;
+    if (i % 2 == 1)
+    {
+      syndrome[i - 1] = static_cast<uint16_t>(laneSyndromes.at(lane, i - 1) | (laneSyndromes.at(lane, i) << 8));
+    }
+    else
+    {
+      syndrome[i - 1] = field->mul(syndrome[i / 2 - 1], syndrome[i / 2 - 1]);
+    }
   }
+}
+
+const BCHCode::DecodeTable &BCHCode::getDecodeTable()
+{
+  if (!decodeTable)
+  {
+    // The table depends only on g(x) and n
+    uint64_t key = static_cast<uint64_t>(n) << 32;
+    for (size_t j = 0; j < g.size(); j++)
+    {
+      key |= static_cast<uint64_t>(g[j]) << j;
+    }
 
-  int k = 1;
+    static std::mutex mutex;
+    static std::map<uint64_t, std::shared_ptr<const DecodeTable>> tables;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const DecodeTable> &entry = tables[key];
+    if (!entry)
+    {
+      auto table = std::make_shared<DecodeTable>();
+      buildDecodeTable(*table);
+      entry = table;
+    }
+    decodeTable = entry;
+  }
+  return *decodeTable;
+}
 
-  // Main algorithm loop
-  for (int i = 1; i < t; i++)
+void BCHCode::buildDecodeTable(DecodeTable &table)
+{
+  // Remainder of each single-bit error
+  std::vector<uint32_t> unitRemainders(n);
+  BitBuffer unit;
+  for (int p = 0; p < n; p++)
   {
-    d[i + 1] = syndrome[i];
+    unit.reset(n);
+    unit.flip(p);
+    computeRemainder(unit);
+    unitRemainders[p] = static_cast<uint32_t>(parityRegister[0]);
+  }
 
-    for (int j = 1; j <= l[i]; j++)
+  // The remainder is linear in the received word: XOR one entry per byte
+  const int bytes = (n + 7) / 8;
+  table.byteRemainders.assign(static_cast<size_t>(bytes) * 256, 0);
+  for (int b = 0; b < bytes; b++)
+  {
+    for (int v = 0; v < 256; v++)
     {
-      if (elp[j] != 0 && syndrome[i - j] != 0)
+      for (int bit = 0; bit < 8 && 8 * b + bit < n; bit++)
       {
-        d[i + 1] ^= alphaTo[(indexOf[elp[j]] + indexOf[syndrome[i - j]]) % n];
+        if ((v >> bit) & 1)
+        {
+          table.byteRemainders[b * 256 + v] ^= unitRemainders[8 * b + bit];
+        }
       }
     }
+  }
+
+  // Patterns of weight up to t have distinct remainders, since the minimum
+  // distance is at least 2t + 1
+  table.patterns.assign(size_t(1) << (n - k), UNCORRECTABLE);
+  table.patterns[0] = 0;
+  addErrorPatterns(unitRemainders, 0, t, 0, 0, table.patterns);
+}
 
-    if (d[i + 1] == 0)
+int BCHCode::findErrorLocator()
+{
+  // Simplified inversionless Berlekamp-Massey for binary codes. With
+  // S_2i = S_i^2 every other discrepancy is zero, so only the t steps on
+  // S_1, S_3, .. run, and Lambda <- gamma * Lambda + delta * x * B replaces
+  // the division by the previous discrepancy. Polynomials are stored
+  // lowest degree first.
+  const int size = 2 * t + 1;
+  std::fill(locator.begin(), locator.end(), 0);
+  std::fill(previous.begin(), previous.end(), 0);
+  locator[0] = 1;
+  previous[0] = 1;
+
+  int length = 0;    // Current LFSR length L
+  uint16_t gamma = 1; // Discrepancy at the last length change
+
+  for (int r = 0; r < 2 * t; r += 2)
+  {
+    // Discrepancy between S_(r+1) and the LFSR prediction
+    uint16_t delta = 0;
+    for (int i = 0; i <= std::min(length, r); i++)
     {
-      l[i + 1] = l[i];
-      for (int j = 0; j <= l[i]; j++)
-      {
-        elp[j + i + 1 - k] = elp[j];
-      }
+      delta ^= field->mul(locator[i], syndromeBuffer[r - i]);
+    }
+
+    std::copy(locator.begin(), locator.end(), saved.begin());
+    locator[0] = field->mul(gamma, saved[0]);
+    for (int i = 1; i < size; i++)
+    {
+      locator[i] = field->mul(gamma, saved[i]) ^ field->mul(delta, previous[i - 1]);
+    }
+
+    // B becomes x * Lambda on a length change, x^2 * B otherwise (the
+    // skipped even step shifts it once more)
+    if (delta != 0 && 2 * length <= r)
+    {
+      previous[0] = 0;
+      std::copy(saved.begin(), saved.end() - 1, previous.begin() + 1);
+      length = r + 1 - length;
+      gamma = delta;
     }
     else
     {
-      int m;
-      for (m = 1; m <= k && d[m] == 0; m++)
-        ;
+      std::copy_backward(previous.begin(), previous.end() - 2, previous.end());
+      previous[0] = 0;
+      previous[1] = 0;
+    }
+  }
+
+  // More errors than the code can correct
+  if (length > t)
+  {
+    return -1;
+  }
+  return length;
+}
+
+int BCHCode::findErrorPositions(int degree)
+{
+  // Bit i has degree e = n-1-i and is in error when Lambda(alpha^-e) = 0.
+  // The term Lambda_k x^k at x = alpha^-(n-1-i) has the log
+  // log(Lambda_k) - k(n-1-i), which grows by k from one bit to the next.
+  const int order = field->order;
+  int terms = 0;
+  for (int j = 1; j <= degree; j++)
+  {
+    if (locator[j] != 0)
+    {
+      termDegree[terms] = j;
+      termLog[terms] = static_cast<int>((field->log[locator[j]] + order -
+                                         static_cast<int64_t>(j) * (n - 1) % order) % order);
+      terms++;
+    }
+  }
 
-      if (m <= k && l[m] < l[i])
+#ifdef BCH_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2())
+  {
+    // Values of each term at bits 0 .. 31, and the byte shuffle tables for
+    // multiplying them by alpha^(32k): nibble q of a value contributes
+    // x * 16^q * alpha^(32k) (tables q for the low byte, 4 + q for the high
+    // byte, each repeated in both 128-bit lanes)
+    for (int c = 0; c < terms; c++)
+    {
+      uint8_t *plane = &chienPlanes[64 * static_cast<size_t>(c)];
+      for (int j = 0; j < 32; j++)
       {
-        l[i + 1] = l[i];
-        for (int j = 0; j <= l[i]; j++)
-        {
-          b[j + i + 1 - k] = elp[j] ^ alphaTo[(indexOf[d[i + 1]] + n - indexOf[d[m]] + indexOf[b[j + m - k]]) % n];
-        }
+        uint16_t value = field->exp[(termLog[c] + static_cast<int64_t>(termDegree[c]) * j) % order];
+        plane[j] = static_cast<uint8_t>(value);
+        plane[32 + j] = static_cast<uint8_t>(value >> 8);
       }
-      else
-      {
-        l[i + 1] = i + 1 - k;
-        for (int j = 0; j <= l[k]; j++)
-        {
-          b[j] = elp[j];
-        }
 
-        for (int j = 0; j <= l[i]; j++)
+      uint8_t *table = &chienTables[256 * static_cast<size_t>(c)];
+      uint16_t step = field->exp[32 * static_cast<int64_t>(termDegree[c]) % order];
+      for (int q = 0; q < 4; q++)
+      {
+        for (int x = 0; x < 16; x++)
         {
-          if (elp[j] != 0 && d[i + 1] != 0)
-          {
-            elp[j + i + 1 - k] = elp[j] ^ alphaTo[(indexOf[d[i + 1]] + n - indexOf[d[k]] + indexOf[b[j]]) % n];
-          }
-          else
-          {
-            elp[j + i + 1 - k] = elp[j];
-          }
+          uint16_t product = (x << (4 * q)) < field->size ? field->mul(static_cast<uint16_t>(x << (4 * q)), step) : 0;
+          table[32 * q + x] = table[32 * q + 16 + x] = static_cast<uint8_t>(product);
+          table[32 * (4 + q) + x] = table[32 * (4 + q) + 16 + x] = static_cast<uint8_t>(product >> 8);
         }
       }
-
-      k = i + 1;
     }
+    return chienAvx2(locator[0], chienPlanes.data(), chienTables.data(), terms, n, degree, positions.data());
   }
+#endif
 
-  // Find roots of the error locator polynomial using Chien search
-  for (int i = 1; i <= n; i++)
+  int found = 0;
+  for (int i = 0; i < n && found < degree; i++)
   {
-    uint16_t sum = 0;
-    for (int j = 0; j <= l[t]; j++)
+    uint16_t sum = locator[0];
+    for (int c = 0; c < terms; c++)
     {
-      if (elp[j] != 0)
+      sum ^= field->exp[termLog[c]];
+      termLog[c] += termDegree[c];
+      if (termLog[c] >= order)
       {
-        sum ^= alphaTo[(indexOf[elp[j]] + j * i) % n];
+        termLog[c] -= order;
       }
     }
 
     if (sum == 0)
     {
-      errorLocations.push_back(n - i); // Root found - this is an error location
+      positions[found++] = i;
     }
   }
 
-  return errorLocations;
+  return found;
 }
 
-std::pair<std::vector<bool>, int> BCHCode::decode(const std::vector<bool> &input)
+int BCHCode::decode(ConstBitSpan input, BitBuffer &output)
 {
   // Ensure received word has correct length
   if (static_cast<int>(input.size()) != n)
   {
-    return {{}, 0}; // Error: Invalid input size
+    output.clear();
+    return 0; // Error: Invalid input size
   }
 
-  // Make a copy of the received word
-  std::vector<bool> received = input;
+  output.resize(k);
+  return decodeBatch(input, ConstBitSpan(), output, nullptr);
+}
 
-  // Compute syndromes
-  std::vector<uint16_t> syndrome = computeSyndrome(received);
+int BCHCode::decodeBatch(ConstBitSpan codewords, ConstBitSpan, BitSpan messages, CodewordStatus *status)
+{
+  size_t count = batchSize(messages.size(), codewords.size());
+  int errorsFixed = 0;
 
-  // Check if all syndromes are zero (no errors)
-  bool errorFree = true;
-  for (size_t i = 0; i < syndrome.size(); i++)
+  // Short codes: one remainder and one table lookup per codeword
+  if (useDecodeTable())
   {
-    if (syndrome[i] != 0)
+    const DecodeTable &table = getDecodeTable();
+    for (size_t c = 0; c < count; c++)
     {
-      errorFree = false;
-      break;
+      uint64_t word = codewords.getBits(c * n, n);
+      uint32_t remainder = 0;
+      for (int b = 0; 8 * b < n; b++)
+      {
+        remainder ^= table.byteRemainders[b * 256 + ((word >> (8 * b)) & 0xFF)];
+      }
+
+      CodewordStatus outcome;
+      uint64_t pattern = table.patterns[remainder];
+      if (pattern != UNCORRECTABLE)
+      {
+        word ^= pattern;
+        outcome.corrected = __builtin_popcountll(pattern);
+      }
+      else
+      {
+        outcome.failed = true;
+      }
+
+      messages.setBits(c * k, k, word);
+      errorsFixed += outcome.corrected;
+      if (status)
+      {
+        status[c] = outcome;
+      }
     }
+    return errorsFixed;
   }
 
-  int errorsFixed = 0;
+  bool useLanes = false;
+#ifdef BCH_HAVE_AVX2_KERNELS
+  useLanes = !laneSyndromeTables.empty() && CpuFeatures::hasAvx2();
+#endif
 
-  if (!errorFree)
+  for (size_t first = 0; first < count; first += LANE_GROUP)
   {
-    try
-    {
-      // Find error locations
-      std::vector<int> errorLocations = findErrorLocations(syndrome);
-      errorsFixed = errorLocations.size();
+    size_t last = std::min(count, first + LANE_GROUP);
 
-      // Correct errors - simply flip the bits at error locations
-      for (int loc : errorLocations)
+    // A clean codeword leaves no remainder; the others are collected lane by lane
+    size_t dirty[LANE_GROUP];
+    size_t dirtyCount = 0;
+    for (size_t c = first; c < last; c++)
+    {
+      ConstBitSpan received = codewords.subspan(c * n, n);
+      messages.subspan(c * k, k).copyFrom(received.subspan(0, k));
+      if (status)
       {
-        if (loc >= 0 && loc < n)
-        {
-          received[loc] = !received[loc];
-        }
+        status[c] = CodewordStatus();
       }
 
-      // Verify correction by recomputing syndrome
-      std::vector<uint16_t> checkSyndrome = computeSyndrome(received);
-      bool allZero = true;
-      for (auto &s : checkSyndrome)
+      if (computeRemainder(received))
       {
-        if (s != 0)
+        if (useLanes)
         {
-          allZero = false;
-          break;
+          for (int q = 0; q < remainderBytes; q++)
+          {
+            laneRemainders.at(dirtyCount, q) = static_cast<uint8_t>(parityRegister[q / 8] >> (8 * (q % 8)));
+          }
+          dirty[dirtyCount++] = c;
+        }
+        else
+        {
+          computeSyndromes(syndromeBuffer);
+          errorsFixed += correctCodeword(messages.subspan(c * k, k), status ? status + c : nullptr);
         }
       }
+    }
 
-      if (!allZero)
+#ifdef BCH_HAVE_AVX2_KERNELS
+    if (dirtyCount >= SYNDROME_LANE_MIN)
+    {
+      syndromesLanesAvx2(laneRemainders.row(0), laneSyndromes.row(0), laneRemainders.stride(), remainderBytes, t,
+                         m > 8, laneSyndromeTables.data());
+    }
+#endif
+
+    for (size_t d = 0; d < dirtyCount; d++)
+    {
+      if (dirtyCount >= SYNDROME_LANE_MIN)
+      {
+        laneSyndrome(d, syndromeBuffer);
+      }
+      else
       {
-        // Correction failed, too many errors
-        errorsFixed = 0;
+        // Too few to share the kernel: restore the remainder for the scalar evaluation
+        std::fill(parityRegister.begin(), parityRegister.end(), 0);
+        for (int q = 0; q < remainderBytes; q++)
+        {
+          parityRegister[q / 8] |= static_cast<uint64_t>(laneRemainders.at(d, q)) << (8 * (q % 8));
+        }
+        computeSyndromes(syndromeBuffer);
       }
+      size_t c = dirty[d];
+      errorsFixed += correctCodeword(messages.subspan(c * k, k), status ? status + c : nullptr);
     }
-    catch (const std::exception &e)
+  }
+
+  return errorsFixed;
+}
+
+int BCHCode::correctCodeword(BitSpan message, CodewordStatus *status)
+{
+  // Every root of the locator must be a bit of the codeword, or there
+  // were too many errors and the word is left as received
+  int degree = findErrorLocator();
+  if (degree <= 0 || findErrorPositions(degree) != degree)
+  {
+    if (status)
     {
-      // Error correction failed
-      errorsFixed = 0;
+      status->failed = true;
     }
+    return 0;
   }
 
-  // Extract the message bits (first k bits)
-  std::vector<bool> decoded(k);
-  for (int i = 0; i < k; i++)
+  // Errors in the parity need no flip
+  for (int l = 0; l < degree; l++)
   {
-    decoded[i] = received[i];
+    if (positions[l] < k)
+    {
+      message.flip(positions[l]);
+    }
   }
-
-  return {decoded, errorsFixed};
+  if (status)
+  {
+    status->corrected = degree;
+  }
+  return degree;
 }
@@ -0,0 +1,118 @@
+#include "../include/bernoulli_noise.h"
+#include <cmath>
+
+BernoulliNoise::BernoulliNoise(double probability)
+{
+  setProbability(probability);
+}
+
+void BernoulliNoise::setProbability(double newProbability)
+{
+  // Ensure probability is in the range [0, 1]
+  if (newProbability < 0.0)
+  {
+    probability = 0.0;
+  }
+  else if (newProbability > 1.0)
+  {
+    probability = 1.0;
+  }
+  else
+  {
+    probability = newProbability;
+  }
+
+  logComplement = std::log1p(-probability);
+
+  // Round to the nearest 32-bit fraction; 1.0 saturates just below one
+  double scaled = std::nearbyint(probability * 4294967296.0);
+  rateFraction = scaled >= 4294967295.0 ? 0xFFFFFFFFu : static_cast<uint32_t>(scaled);
+  rateLowestBit = rateFraction == 0 ? 31 : __builtin_ctz(rateFraction);
+}
+
+void BernoulliNoise::apply(BitSpan bits, Philox &rng) const
+{
+  if (probability <= 0.0)
+  {
+    return;
+  }
+
+  if (probability < SPARSE_THRESHOLD)
+  {
+    applySparse(bits, rng);
+  }
+  else
+  {
+    applyDense(bits, rng);
+  }
+}
+
+uint64_t BernoulliNoise::sampleGap(Philox &rng) const
+{
+  if (probability <= 0.0)
+  {
+    return UINT64_MAX;
+  }
+
+  // Inverting the geometric CDF with a uniform U in (0, 1] gives
+  // gap = floor(log(U) / log(1 - p))
+  double gap = std::floor(std::log(rng.nextOpenUniform()) / logComplement);
+  return gap >= 18446744073709551615.0 ? UINT64_MAX : static_cast<uint64_t>(gap);
+}
+
+uint64_t BernoulliNoise::noiseWord(Philox &rng) const
+{
+  // Write p = sum(b_j * 2^-j) for j = 1..32. Starting from x = 0 and walking
+  // the fraction bits from least to most significant, x = b_j ? (x | r) : (x & r)
+  // with a fresh uniform word r turns the probability of each bit of x from q
+  // into b_j / 2 + q / 2, which ends at exactly p. Bits below the lowest set
+  // bit of the fraction would only AND into zero, so they are skipped.
+  uint64_t r[32];
+  int draws = 32 - rateLowestBit;
+  rng.fill(r, draws);
+
+  uint64_t x = r[0];
+  for (int j = 1; j < draws; j++)
+  {
+    x = ((rateFraction >> (rateLowestBit + j)) & 1) ? (x | r[j]) : (x & r[j]);
+  }
+  return x;
+}
+
+void BernoulliNoise::applyDense(BitSpan bits, Philox &rng) const
+{
+  size_t i = 0;
+
+  // XOR 64 bits of Bernoulli(p) noise at a time, then the remaining tail
+  for (; i + 64 <= bits.size(); i += 64)
+  {
+    bits.xorBits(i, 64, noiseWord(rng));
+  }
+  if (i < bits.size())
+  {
+    bits.xorBits(i, static_cast<int>(bits.size() - i), noiseWord(rng));
+  }
+}
+
+void BernoulliNoise::applySparse(BitSpan bits, Philox &rng) const
+{
+  // The number of correct bits before the next error is geometric. Because
+  // the geometric distribution is memoryless, restarting the process on every
+  // call is equivalent to flipping each bit independently.
+  uint64_t remaining = bits.size();
+  size_t pos = 0;
+
+  while (true)
+  {
+    uint64_t gap = sampleGap(rng);
+    if (gap >= remaining)
+    {
+      break;
+    }
+
+    pos += gap;
+    bits.flip(pos);
+    pos++;
+    remaining -= gap + 1;
+  }
+}
@@ -0,0 +1,145 @@
+#include "../include/bit_buffer.h"
+#include <algorithm>
+
+size_t ConstBitSpan::count() const
+{
+  size_t total = 0;
+  size_t i = 0;
+
+  // Count 64 bits at a time, then the remaining tail
+  for (; i + 64 <= bitCount; i += 64)
+  {
+    total += __builtin_popcountll(getBits(i, 64));
+  }
+  if (i < bitCount)
+  {
+    total += __builtin_popcountll(getBits(i, static_cast<int>(bitCount - i)));
+  }
+
+  return total;
+}
+
+std::vector<bool> ConstBitSpan::toVector() const
+{
+  std::vector<bool> bits(bitCount);
+  for (size_t i = 0; i < bitCount; i++)
+  {
+    bits[i] = (*this)[i];
+  }
+  return bits;
+}
+
+void BitSpan::copyFrom(ConstBitSpan source)
+{
+  size_t count = std::min(bitCount, source.size());
+  size_t i = 0;
+
+  // Word-aligned views copy whole words
+  if (bitOffset == 0 && source.offset() == 0)
+  {
+    i = count & ~size_t(63);
+    std::copy(source.words(), source.words() + i / 64, wordPtr);
+  }
+
+  for (; i + 64 <= count; i += 64)
+  {
+    setBits(i, 64, source.getBits(i, 64));
+  }
+  if (i < count)
+  {
+    int rest = static_cast<int>(count - i);
+    setBits(i, rest, source.getBits(i, rest));
+  }
+}
+
+void BitSpan::fill(bool value)
+{
+  uint64_t pattern = value ? ~uint64_t(0) : 0;
+  size_t i = 0;
+
+  for (; i + 64 <= bitCount; i += 64)
+  {
+    setBits(i, 64, pattern);
+  }
+  if (i < bitCount)
+  {
+    setBits(i, static_cast<int>(bitCount - i), pattern);
+  }
+}
+
+BitBuffer::BitBuffer(const std::vector<bool> &bits) : bitCount(0)
+{
+  assign(bits);
+}
+
+BitBuffer::BitBuffer(ConstBitSpan bits) : bitCount(0)
+{
+  assign(bits);
+}
+
+void BitBuffer::clearTail()
+{
+  int used = static_cast<int>(bitCount & 63);
+  if (used != 0)
+  {
+    storage.back() &= (uint64_t(1) << used) - 1;
+  }
+}
+
+void BitBuffer::resize(size_t size)
+{
+  storage.resize((size + 63) / 64, 0);
+  bitCount = size;
+  clearTail();
+}
+
+void BitBuffer::reset(size_t size)
+{
+  storage.assign((size + 63) / 64, 0);
+  bitCount = size;
+}
+
+void BitBuffer::pushBack(bool value)
+{
+  if ((bitCount & 63) == 0)
+  {
+    storage.push_back(0);
+  }
+  if (value)
+  {
+    storage[bitCount >> 6] |= uint64_t(1) << (bitCount & 63);
+  }
+  bitCount++;
+}
+
+void BitBuffer::appendBits(uint64_t value, int count)
+{
+  size_t pos = bitCount;
+  resize(bitCount + count);
+  setBits(pos, count, value);
+}
+
+void BitBuffer::append(ConstBitSpan bits)
+{
+  size_t pos = bitCount;
+  resize(bitCount + bits.size());
+  span().subspan(pos, bits.size()).copyFrom(bits);
+}
+
+void BitBuffer::assign(ConstBitSpan bits)
+{
+  resize(bits.size());
+  span().copyFrom(bits);
+}
+
+void BitBuffer::assign(const std::vector<bool> &bits)
+{
+  reset(bits.size());
+  for (size_t i = 0; i < bits.size(); i++)
+  {
+    if (bits[i])
+    {
+      storage[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+  }
+}
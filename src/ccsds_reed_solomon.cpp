@@ -0,0 +1,78 @@
+#include "../include/ccsds_reed_solomon.h"
+#include <stdexcept>
+
+namespace
+{
+  const int FIELD_POLYNOMIAL = 0x187; // x^8 + x^7 + x^2 + x + 1
+  const int FIRST_ROOT = 112;
+  const int ROOT_STEP = 11;
+  const int DATA_SIZE = 223;
+  const int PARITY_SIZE = 32;
+
+  // Dual-basis images of alpha^7 .. alpha^0 (CCSDS 131.0-B, Annex F)
+  const uint8_t DUAL_BASIS[8] = {0x8d, 0xef, 0xec, 0x86, 0xfa, 0x99, 0xaf, 0x7b};
+
+  uint8_t reverseBits(uint8_t x)
+  {
+    x = static_cast<uint8_t>((x >> 4) | (x << 4));
+    x = static_cast<uint8_t>(((x & 0xCC) >> 2) | ((x & 0x33) << 2));
+    return static_cast<uint8_t>(((x & 0xAA) >> 1) | ((x & 0x55) << 1));
+  }
+
+  int checkedDataSize(int interleave, int virtualFill)
+  {
+    if (interleave < 1 || interleave > 8)
+    {
+      throw std::invalid_argument("CCSDS interleave depth must be between 1 and 8");
+    }
+    if (virtualFill < 0 || virtualFill >= DATA_SIZE)
+    {
+      throw std::invalid_argument("CCSDS virtual fill must be between 0 and 222 symbols");
+    }
+    return DATA_SIZE - virtualFill;
+  }
+}
+
+CcsdsReedSolomon::CcsdsReedSolomon(int interleave, int virtualFill, bool dualBasis)
+    : ReedSolomon(8, checkedDataSize(interleave, virtualFill), PARITY_SIZE, FIELD_POLYNOMIAL,
+                  FIRST_ROOT, ROOT_STEP, interleave),
+      dualBasis(dualBasis)
+{
+  // The bit stream carries the first bit of each symbol in its least
+  // significant bit; CCSDS sends the most significant bit first
+  std::vector<uint8_t> inputMap(256);
+  std::vector<uint8_t> outputMap(256);
+  for (int x = 0; x < 256; x++)
+  {
+    uint8_t dual = static_cast<uint8_t>(x);
+    if (dualBasis)
+    {
+      dual = 0;
+      for (int k = 0; k < 8; k++)
+      {
+        if (x & (1 << k))
+        {
+          dual ^= DUAL_BASIS[7 - k];
+        }
+      }
+    }
+    outputMap[x] = reverseBits(dual);
+    inputMap[reverseBits(dual)] = static_cast<uint8_t>(x);
+  }
+
+  setSymbolMaps(std::move(inputMap), std::move(outputMap));
+}
+
+std::string CcsdsReedSolomon::getName() const
+{
+  std::string name = "CCSDS RS(" + std::to_string(dataSize + paritySize) + "," + std::to_string(dataSize) + ")";
+  if (interleave > 1)
+  {
+    name += " I=" + std::to_string(interleave);
+  }
+  if (!dualBasis)
+  {
+    name += " conventional";
+  }
+  return name;
+}
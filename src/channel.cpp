@@ -1,54 +1,52 @@
 #include "../include/channel.h"
-#include <random>
 #include <chrono>
+#include <sstream>
 
-Channel::Channel(double errorRate) : errorRate(errorRate)
+Channel::Channel(double errorRate) : noise(errorRate)
 {
   // Initialize random number generator with current time as seed
-  unsigned seed = static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count());
-  rng = std::mt19937(seed);
-  dist = std::uniform_real_distribution<double>(0.0, 1.0);
+  uint64_t seed = static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+  rng.reseed(seed, 0);
 }
 
-std::vector<bool> Channel::transmit(const std::vector<bool> &input)
+Channel::Channel(double errorRate, uint64_t seed, uint64_t stream)
+    : noise(errorRate), rng(seed, stream)
 {
-  // Create a copy of the input
-  std::vector<bool> output = input;
+}
+
+std::string Channel::getName() const
+{
+  std::ostringstream name;
+  name << "BSC(p=" << noise.getProbability() << ")";
+  return name.str();
+}
+
+std::unique_ptr<ChannelModel> Channel::clone() const
+{
+  return std::make_unique<Channel>(*this);
+}
 
-  // Apply random bit flips based on the error rate
-  for (size_t i = 0; i < output.size(); i++)
-  {
-    // Generate a random value between 0 and 1
-    double randomValue = dist(rng);
+void Channel::reseed(uint64_t seed, uint64_t stream)
+{
+  rng.reseed(seed, stream);
+}
 
-    // If the random value is less than the error rate, flip the bit
-    if (randomValue < errorRate)
-    {
-      output[i] = !output[i];
-    }
-  }
+void Channel::seek(uint64_t block)
+{
+  rng.seek(block);
+}
 
-  return output;
+void Channel::transmit(BitSpan bits)
+{
+  noise.apply(bits, rng);
 }
 
 void Channel::setErrorRate(double newErrorRate)
 {
-  // Ensure error rate is in the range [0, 1]
-  if (newErrorRate < 0.0)
-  {
-    errorRate = 0.0;
-  }
-  else if (newErrorRate > 1.0)
-  {
-    errorRate = 1.0;
-  }
-  else
-  {
-    errorRate = newErrorRate;
-  }
+  noise.setProbability(newErrorRate);
 }
 
 double Channel::getErrorRate() const
 {
-  return errorRate;
+  return noise.getProbability();
 }
@@ -0,0 +1,10 @@
+#include "../include/channel_model.h"
+
+std::vector<bool> ChannelModel::transmit(const std::vector<bool> &input)
+{
+  // Create a packed copy of the input and corrupt it
+  BitBuffer output(input);
+  transmit(output);
+
+  return output.toVector();
+}
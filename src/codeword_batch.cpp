@@ -0,0 +1,180 @@
+#include "../include/codeword_batch.h"
+#include "../include/cpu_features.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BATCH_HAVE_AVX2_KERNELS 1
+#endif
+
+namespace
+{
+  // Symbols per tile of the vector transposes
+  const size_t TILE_SYMBOLS = 16;
+
+  // First symbol of codeword b in the stream layout of CodewordBatch::load
+  inline size_t codewordStart(size_t blockSize, size_t depth, size_t b)
+  {
+    return (b / depth) * blockSize + b % depth;
+  }
+
+#ifdef BATCH_HAVE_AVX2_KERNELS
+  /*
+   * Transpose the 16 x 16 byte matrix in each 128-bit half of r, so byte c
+   * of r[i] ends up as byte i of r[c]. Each round of unpacks doubles the
+   * unit size, from bytes to 64-bit halves.
+   */
+  __attribute__((target("avx2"))) inline void transpose16(__m256i r[16])
+  {
+    __m256i t[16];
+    for (int i = 0; i < 8; i++)
+    {
+      // t[8h + i]: columns 8h .. 8h + 7 of rows 2i, 2i + 1
+      t[i] = _mm256_unpacklo_epi8(r[2 * i], r[2 * i + 1]);
+      t[i + 8] = _mm256_unpackhi_epi8(r[2 * i], r[2 * i + 1]);
+    }
+    for (int h = 0; h < 16; h += 8)
+    {
+      for (int i = 0; i < 4; i++)
+      {
+        // r[h + i]: four columns of rows 4i .. 4i + 3
+        r[h + i] = _mm256_unpacklo_epi16(t[h + 2 * i], t[h + 2 * i + 1]);
+        r[h + i + 4] = _mm256_unpackhi_epi16(t[h + 2 * i], t[h + 2 * i + 1]);
+      }
+    }
+    for (int q = 0; q < 16; q += 4)
+    {
+      for (int i = 0; i < 2; i++)
+      {
+        // t[q + i]: two columns of rows 8i .. 8i + 7
+        t[q + i] = _mm256_unpacklo_epi32(r[q + 2 * i], r[q + 2 * i + 1]);
+        t[q + i + 2] = _mm256_unpackhi_epi32(r[q + 2 * i], r[q + 2 * i + 1]);
+      }
+    }
+    for (int p = 0; p < 16; p += 2)
+    {
+      r[p] = _mm256_unpacklo_epi64(t[p], t[p + 1]);
+      r[p + 1] = _mm256_unpackhi_epi64(t[p], t[p + 1]);
+    }
+  }
+
+  // Load symbols [j, j + 16) of 32 row-major codewords into rows j .. j + 15 of a batch
+  __attribute__((target("avx2"))) void loadTile(const uint8_t *stream, size_t blockSize, uint8_t *rows,
+                                                size_t stride)
+  {
+    __m256i r[16];
+    for (int i = 0; i < 16; i++)
+    {
+      __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stream + i * blockSize));
+      __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(stream + (i + 16) * blockSize));
+      r[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+    }
+    transpose16(r);
+    for (int i = 0; i < 16; i++)
+    {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(rows + i * stride), r[i]);
+    }
+  }
+
+  // Inverse of loadTile
+  __attribute__((target("avx2"))) void storeTile(const uint8_t *rows, size_t stride, uint8_t *stream,
+                                                 size_t blockSize)
+  {
+    __m256i r[16];
+    for (int i = 0; i < 16; i++)
+    {
+      r[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows + i * stride));
+    }
+    transpose16(r);
+    for (int i = 0; i < 16; i++)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(stream + i * blockSize), _mm256_castsi256_si128(r[i]));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(stream + (i + 16) * blockSize), _mm256_extracti128_si256(r[i], 1));
+    }
+  }
+#endif
+}
+
+void CodewordBatch::resize(size_t lanes, size_t symbols)
+{
+  laneCount = lanes;
+  symbolCount = symbols;
+  rowStride = (lanes + LANE_GROUP - 1) / LANE_GROUP * LANE_GROUP;
+  storage.assign(rowStride * symbols, 0);
+}
+
+void CodewordBatch::load(const uint8_t *blocks, size_t blockSize, size_t depth, size_t first, size_t count)
+{
+  size_t l = 0;
+
+#ifdef BATCH_HAVE_AVX2_KERNELS
+  // Whole tiles of 32 row-major codewords and 16 symbols
+  if (depth == 1 && CpuFeatures::hasAvx2())
+  {
+    size_t tiled = count / TILE_SYMBOLS * TILE_SYMBOLS;
+    for (; l + LANE_GROUP <= laneCount; l += LANE_GROUP)
+    {
+      const uint8_t *stream = blocks + (first + l) * blockSize;
+      for (size_t j = 0; j < tiled; j += TILE_SYMBOLS)
+      {
+        loadTile(stream + j, blockSize, row(j) + l, rowStride);
+      }
+      for (size_t lane = l; lane < l + LANE_GROUP; lane++)
+      {
+        const uint8_t *symbols = blocks + (first + lane) * blockSize;
+        for (size_t j = tiled; j < count; j++)
+        {
+          at(lane, j) = symbols[j];
+        }
+      }
+    }
+  }
+#endif
+
+  // Remaining lanes one codeword at a time
+  for (; l < laneCount; l++)
+  {
+    const uint8_t *symbols = blocks + codewordStart(blockSize, depth, first + l);
+    for (size_t j = 0; j < count; j++)
+    {
+      at(l, j) = symbols[j * depth];
+    }
+  }
+}
+
+void CodewordBatch::store(uint8_t *blocks, size_t blockSize, size_t depth, size_t first, size_t count) const
+{
+  size_t l = 0;
+
+#ifdef BATCH_HAVE_AVX2_KERNELS
+  if (depth == 1 && CpuFeatures::hasAvx2())
+  {
+    size_t tiled = count / TILE_SYMBOLS * TILE_SYMBOLS;
+    for (; l + LANE_GROUP <= laneCount; l += LANE_GROUP)
+    {
+      uint8_t *stream = blocks + (first + l) * blockSize;
+      for (size_t j = 0; j < tiled; j += TILE_SYMBOLS)
+      {
+        storeTile(row(j) + l, rowStride, stream + j, blockSize);
+      }
+      for (size_t lane = l; lane < l + LANE_GROUP; lane++)
+      {
+        uint8_t *symbols = blocks + (first + lane) * blockSize;
+        for (size_t j = tiled; j < count; j++)
+        {
+          symbols[j] = at(lane, j);
+        }
+      }
+    }
+  }
+#endif
+
+  for (; l < laneCount; l++)
+  {
+    uint8_t *symbols = blocks + codewordStart(blockSize, depth, first + l);
+    for (size_t j = 0; j < count; j++)
+    {
+      symbols[j * depth] = at(l, j);
+    }
+  }
+}
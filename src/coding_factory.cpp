@@ -1,9 +1,172 @@
 #include "../include/coding_factory.h"
 #include "../include/hamming_code.h"
 #include "../include/reed_solomon.h"
+#include "../include/ccsds_reed_solomon.h"
+#include "../include/reed_solomon16.h"
 #include "../include/bch_code.h"
+#include "../include/galois_field.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
 #include <stdexcept>
 
+namespace
+{
+  // Values of a spec such as "BCH(m=6,t=3)": positional ones in order, and named ones
+  struct SpecArguments
+  {
+    std::vector<int> positional;
+    std::map<std::string, int> named;
+  };
+
+  /**
+   * Split "NAME(a,b,key=c)" into NAME and its arguments. Values are
+   * non-negative integers, in decimal or with a 0x prefix in hex.
+   * Returns false when the spec has no argument list.
+   */
+  bool parseSpec(const std::string &spec, std::string &name, SpecArguments &arguments)
+  {
+    size_t open = spec.find('(');
+    if (open == std::string::npos || spec.back() != ')')
+    {
+      return false;
+    }
+    name = spec.substr(0, open);
+
+    std::string list = spec.substr(open + 1, spec.size() - open - 2);
+    size_t start = 0;
+    while (start <= list.size())
+    {
+      size_t comma = std::min(list.find(',', start), list.size());
+      std::string item = list.substr(start, comma - start);
+      start = comma + 1;
+
+      size_t equals = item.find('=');
+      std::string value = equals == std::string::npos ? item : item.substr(equals + 1);
+      char *end = nullptr;
+      errno = 0;
+      long number = std::strtol(value.c_str(), &end, value.compare(0, 2, "0x") == 0 ? 16 : 10);
+      if (value.empty() || *end != '\0' || errno != 0 || number < 0 || number > INT_MAX)
+      {
+        throw std::invalid_argument("Invalid value \"" + value + "\" in coding spec " + spec);
+      }
+
+      if (equals == std::string::npos)
+      {
+        arguments.positional.push_back(static_cast<int>(number));
+      }
+      else
+      {
+        arguments.named[item.substr(0, equals)] = static_cast<int>(number);
+      }
+    }
+    return true;
+  }
+
+  // Remove a named argument and return its value, or fallback when it is
+  // absent (a negative fallback makes it required)
+  int takeNamed(SpecArguments &arguments, const std::string &key, const std::string &spec, int fallback = -1)
+  {
+    auto it = arguments.named.find(key);
+    if (it == arguments.named.end())
+    {
+      if (fallback < 0)
+      {
+        throw std::invalid_argument("Coding spec " + spec + " needs " + key + "=");
+      }
+      return fallback;
+    }
+    int value = it->second;
+    arguments.named.erase(it);
+    return value;
+  }
+
+  // Build the code described by a spec such as "RS(255,223)" or "BCH(m=6,t=3)"
+  std::unique_ptr<CodingStrategy> buildFromSpec(const std::string &spec)
+  {
+    std::string name;
+    SpecArguments arguments;
+    if (!parseSpec(spec, name, arguments))
+    {
+      throw std::invalid_argument("Unknown coding strategy: " + spec);
+    }
+
+    std::unique_ptr<CodingStrategy> code;
+    if (name == "RS")
+    {
+      if (arguments.positional.size() != 2 || arguments.positional[1] >= arguments.positional[0])
+      {
+        throw std::invalid_argument("Coding spec " + spec + " needs RS(n,k) with k < n");
+      }
+      int n = arguments.positional[0];
+      int k = arguments.positional[1];
+
+      // Smallest field with at least n nonzero elements
+      int smallest = 2;
+      while (smallest < 8 && (1 << smallest) - 1 < n)
+      {
+        smallest++;
+      }
+      int m = takeNamed(arguments, "m", spec, n > 255 ? 16 : smallest);
+
+      if (m == 16)
+      {
+        code = std::make_unique<ReedSolomon16>(k, n - k);
+      }
+      else
+      {
+        code = std::make_unique<ReedSolomon>(m, k, n - k);
+      }
+    }
+    else if (name == "BCH")
+    {
+      if (!arguments.positional.empty())
+      {
+        throw std::invalid_argument("Coding spec " + spec + " takes named values only, as in BCH(m=6,t=3)");
+      }
+      int m = takeNamed(arguments, "m", spec);
+      int t = takeNamed(arguments, "t", spec);
+      int shortening = takeNamed(arguments, "shorten", spec, 0);
+      int polynomial = takeNamed(arguments, "poly", spec, 0);
+
+      // Only fields with compiled tables can be used
+      std::vector<int> available = GaloisField::polynomials(m);
+      if (polynomial != 0 && std::find(available.begin(), available.end(), polynomial) == available.end())
+      {
+        std::ostringstream message;
+        message << std::hex << std::uppercase << "Coding spec " << spec << ": no GF(2^" << std::dec << m
+                << ") tables for poly=0x" << std::hex << polynomial;
+        if (available.empty())
+        {
+          message << "; m must be between 2 and 16";
+        }
+        else
+        {
+          message << "; supported:";
+          for (int candidate : available)
+          {
+            message << " 0x" << candidate;
+          }
+        }
+        throw std::invalid_argument(message.str());
+      }
+      code = std::make_unique<BCHCode>(m, t, shortening, polynomial);
+    }
+    else
+    {
+      throw std::invalid_argument("Unknown coding strategy: " + spec);
+    }
+
+    if (!arguments.named.empty())
+    {
+      throw std::invalid_argument("Unknown parameter " + arguments.named.begin()->first + " in coding spec " + spec);
+    }
+    return code;
+  }
+}
+
 CodingFactory &CodingFactory::getInstance()
 {
   static CodingFactory instance;
@@ -15,26 +178,48 @@ CodingFactory::CodingFactory()
   // Register default strategies
   registerStrategy("Hamming(7,4)", std::make_shared<HammingCode>());
   registerStrategy("Reed-Solomon", std::make_shared<ReedSolomon>());
+  registerStrategy("CCSDS RS(255,223)", std::make_shared<CcsdsReedSolomon>());
+  registerStrategy("CCSDS RS(255,223) I=5", std::make_shared<CcsdsReedSolomon>(5));
+  registerStrategy("Reed-Solomon GF(2^16)", std::make_shared<ReedSolomon16>());
   registerStrategy("BCH", std::make_shared<BCHCode>());
+  registerStrategy("BCH DVB-S2 short", std::make_shared<BCHCode>(14, 12, 1983));
+  registerStrategy("BCH DVB-S2 normal", std::make_shared<BCHCode>(16, 8, 7935, 0x1002D));
 }
 
 void CodingFactory::registerStrategy(const std::string &name, std::shared_ptr<CodingStrategy> strategy)
 {
+  std::lock_guard<std::mutex> lock(mutex);
   strategies[name] = strategy;
 }
 
-std::shared_ptr<CodingStrategy> CodingFactory::createStrategy(const std::string &name)
+const CodingStrategy &CodingFactory::findPrototype(const std::string &spec) const
 {
-  auto it = strategies.find(name);
-  if (it == strategies.end())
+  auto it = strategies.find(spec);
+  if (it != strategies.end())
+  {
+    return *it->second;
+  }
+
+  // Build each spec once; spaces inside it do not matter
+  std::string key = spec;
+  key.erase(std::remove(key.begin(), key.end(), ' '), key.end());
+  auto found = specPrototypes.find(key);
+  if (found == specPrototypes.end())
   {
-    throw std::invalid_argument("Unknown coding strategy: " + name);
+    found = specPrototypes.emplace(key, buildFromSpec(key)).first;
   }
-  return it->second;
+  return *found->second;
+}
+
+std::unique_ptr<CodingStrategy> CodingFactory::createStrategy(const std::string &spec)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return findPrototype(spec).clone();
 }
 
 std::vector<std::string> CodingFactory::getStrategyNames() const
 {
+  std::lock_guard<std::mutex> lock(mutex);
   std::vector<std::string> names;
   for (const auto &pair : strategies)
   {
@@ -43,12 +228,8 @@ std::vector<std::string> CodingFactory::getStrategyNames() const
   return names;
 }
 
-std::string CodingFactory::getStrategyDescription(const std::string &name) const
+std::string CodingFactory::getStrategyDescription(const std::string &spec) const
 {
-  auto it = strategies.find(name);
-  if (it == strategies.end())
-  {
-    throw std::invalid_argument("Unknown coding strategy: " + name);
-  }
-  return it->second->getDescription();
+  std::lock_guard<std::mutex> lock(mutex);
+  return findPrototype(spec).getDescription();
 }
@@ -0,0 +1,85 @@
+#include "../include/coding_strategy.h"
+#include <algorithm>
+#include <stdexcept>
+
+std::vector<bool> CodingStrategy::encode(const std::vector<bool> &input)
+{
+  BitBuffer encoded;
+  encode(BitBuffer(input), encoded);
+  return encoded.toVector();
+}
+
+std::pair<std::vector<bool>, int> CodingStrategy::decode(const std::vector<bool> &input)
+{
+  BitBuffer decoded;
+  int errorsFixed = decode(BitBuffer(input), decoded);
+  return {decoded.toVector(), errorsFixed};
+}
+
+int CodingStrategy::decode(ConstBitSpan input, ConstBitSpan, BitBuffer &output)
+{
+  return decode(input, output);
+}
+
+size_t CodingStrategy::batchSize(size_t messageBits, size_t codewordBits) const
+{
+  const size_t k = getMessageLength();
+  const size_t n = getCodewordLength();
+  if (messageBits % k != 0 || codewordBits % n != 0 || messageBits / k != codewordBits / n)
+  {
+    throw std::invalid_argument("Batch must hold the same number of whole messages and codewords");
+  }
+  return codewordBits / n;
+}
+
+void CodingStrategy::encodeBatch(ConstBitSpan messages, BitSpan codewords)
+{
+  const size_t k = getMessageLength();
+  const size_t n = getCodewordLength();
+  size_t count = batchSize(messages.size(), codewords.size());
+
+  for (size_t c = 0; c < count; c++)
+  {
+    encode(messages.subspan(c * k, k), batchBuffer);
+    codewords.subspan(c * n, n).copyFrom(batchBuffer);
+  }
+}
+
+int CodingStrategy::decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                                CodewordStatus *status)
+{
+  const size_t k = getMessageLength();
+  const size_t n = getCodewordLength();
+  size_t count = batchSize(messages.size(), codewords.size());
+  if (!erasures.empty() && erasures.size() != codewords.size())
+  {
+    throw std::invalid_argument("Erasure flags must match the received bits");
+  }
+
+  int errorsFixed = 0;
+  for (size_t c = 0; c < count; c++)
+  {
+    ConstBitSpan received = codewords.subspan(c * n, n);
+    int fixed = erasures.empty() ? decode(received, batchBuffer)
+                                 : decode(received, erasures.subspan(c * n, n), batchBuffer);
+    messages.subspan(c * k, k).copyFrom(batchBuffer);
+    errorsFixed += fixed;
+
+    if (status)
+    {
+      // Without corrections the received word must itself be a codeword
+      bool failed = false;
+      if (fixed == 0)
+      {
+        encode(messages.subspan(c * k, k), checkBuffer);
+        for (size_t i = 0; i < n && !failed; i += 64)
+        {
+          int bits = static_cast<int>(std::min<size_t>(64, n - i));
+          failed = checkBuffer.getBits(i, bits) != received.getBits(i, bits);
+        }
+      }
+      status[c] = {fixed, failed};
+    }
+  }
+  return errorsFixed;
+}
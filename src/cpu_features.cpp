@@ -0,0 +1,67 @@
+#include "../include/cpu_features.h"
+#include <atomic>
+
+namespace CpuFeatures
+{
+  namespace
+  {
+    std::atomic<bool> extensionsEnabled(true);
+
+    bool allowed()
+    {
+      return extensionsEnabled.load(std::memory_order_relaxed);
+    }
+  }
+
+  void setEnabled(bool enabled)
+  {
+    extensionsEnabled.store(enabled, std::memory_order_relaxed);
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+  bool hasAvx2()
+  {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported && allowed();
+  }
+
+  bool hasSsse3()
+  {
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    return supported && allowed();
+  }
+
+  bool hasPclmul()
+  {
+    static const bool supported = __builtin_cpu_supports("pclmul");
+    return supported && allowed();
+  }
+
+  bool hasBmi2()
+  {
+    static const bool supported = __builtin_cpu_supports("bmi2");
+    return supported && allowed();
+  }
+#else
+  bool hasAvx2()
+  {
+    return false;
+  }
+
+  bool hasSsse3()
+  {
+    return false;
+  }
+
+  bool hasPclmul()
+  {
+    return false;
+  }
+
+  bool hasBmi2()
+  {
+    return false;
+  }
+#endif
+
+} // namespace CpuFeatures
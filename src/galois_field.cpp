@@ -0,0 +1,109 @@
+#include "../include/galois_field.h"
+#include <stdexcept>
+#include <string>
+
+int GaloisField::defaultPolynomial(int m)
+{
+  switch (m)
+  {
+  case 2:
+    return 0x7; // x^2 + x + 1
+  case 3:
+    return 0xB; // x^3 + x + 1
+  case 4:
+    return 0x13; // x^4 + x + 1
+  case 5:
+    return 0x25; // x^5 + x^2 + 1
+  case 6:
+    return 0x43; // x^6 + x + 1
+  case 7:
+    return 0x89; // x^7 + x^3 + 1
+  case 8:
+    return 0x11D; // x^8 + x^4 + x^3 + x^2 + 1
+  case 9:
+    return 0x211; // x^9 + x^4 + 1
+  case 10:
+    return 0x409; // x^10 + x^3 + 1
+  case 11:
+    return 0x805; // x^11 + x^2 + 1
+  case 12:
+    return 0x1053; // x^12 + x^6 + x^4 + x + 1
+  case 13:
+    return 0x201B; // x^13 + x^4 + x^3 + x + 1
+  case 14:
+    return 0x402B; // x^14 + x^5 + x^3 + x + 1 (DVB-S2 short frames)
+  case 15:
+    return 0x8003; // x^15 + x + 1
+  case 16:
+    return 0x1100B; // x^16 + x^12 + x^3 + x + 1
+  default:
+    return 0;
+  }
+}
+
+std::vector<int> GaloisField::polynomials(int m)
+{
+  std::vector<int> available;
+  if (defaultPolynomial(m) != 0)
+  {
+    available.push_back(defaultPolynomial(m));
+  }
+  if (m == 8)
+  {
+    available.push_back(0x187); // CCSDS
+  }
+  if (m == 16)
+  {
+    available.push_back(0x1002D); // DVB-S2 normal frames
+  }
+  return available;
+}
+
+const GaloisField &GaloisField::get(int m, int polynomial)
+{
+  if (m < 2 || (polynomial >> m) != 1)
+  {
+    throw std::invalid_argument("Field polynomial must have degree " + std::to_string(m));
+  }
+
+  switch (polynomial)
+  {
+  case 0x7:
+    return GF<2, 0x7>::view();
+  case 0xB:
+    return GF<3, 0xB>::view();
+  case 0x13:
+    return GF<4, 0x13>::view();
+  case 0x25:
+    return GF<5, 0x25>::view();
+  case 0x43:
+    return GF<6, 0x43>::view();
+  case 0x89:
+    return GF<7, 0x89>::view();
+  case 0x11D:
+    return GF<8, 0x11D>::view();
+  case 0x187:
+    return GF<8, 0x187>::view(); // CCSDS
+  case 0x211:
+    return GF<9, 0x211>::view();
+  case 0x409:
+    return GF<10, 0x409>::view();
+  case 0x805:
+    return GF<11, 0x805>::view();
+  case 0x1053:
+    return GF<12, 0x1053>::view();
+  case 0x201B:
+    return GF<13, 0x201B>::view();
+  case 0x402B:
+    return GF<14, 0x402B>::view();
+  case 0x8003:
+    return GF<15, 0x8003>::view();
+  case 0x1100B:
+    return GF<16, 0x1100B>::view();
+  case 0x1002D:
+    return GF<16, 0x1002D>::view(); // DVB-S2 normal frames
+  default:
+    throw std::invalid_argument("No GF(2^" + std::to_string(m) + ") table for polynomial " +
+                                std::to_string(polynomial));
+  }
+}
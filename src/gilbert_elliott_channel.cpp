@@ -0,0 +1,80 @@
+#include "../include/gilbert_elliott_channel.h"
+#include <algorithm>
+#include <sstream>
+
+GilbertElliottChannel::GilbertElliottChannel(double goodToBad, double badToGood,
+                                             double goodErrorRate, double badErrorRate,
+                                             uint64_t seed, uint64_t stream)
+    : leaveGood(goodToBad), leaveBad(badToGood),
+      goodNoise(goodErrorRate), badNoise(badErrorRate),
+      inBadState(false), runRemaining(0)
+{
+  reseed(seed, stream);
+}
+
+std::string GilbertElliottChannel::getName() const
+{
+  std::ostringstream name;
+  name << "Gilbert-Elliott(pGB=" << leaveGood.getProbability()
+       << ",pBG=" << leaveBad.getProbability()
+       << ",eG=" << goodNoise.getProbability()
+       << ",eB=" << badNoise.getProbability() << ")";
+  return name.str();
+}
+
+std::unique_ptr<ChannelModel> GilbertElliottChannel::clone() const
+{
+  return std::make_unique<GilbertElliottChannel>(*this);
+}
+
+void GilbertElliottChannel::reseed(uint64_t seed, uint64_t stream)
+{
+  rng.reseed(seed, stream);
+
+  // Start from the stationary distribution so short frames are unbiased
+  inBadState = rng.nextOpenUniform() <= getBadStateProbability();
+  runRemaining = sampleRunLength();
+}
+
+uint64_t GilbertElliottChannel::sampleRunLength()
+{
+  // A stay ends after each bit with the leave probability, so its length is
+  // one plus a geometric number of bits that stay
+  uint64_t gap = (inBadState ? leaveBad : leaveGood).sampleGap(rng);
+  return gap == UINT64_MAX ? gap : gap + 1;
+}
+
+void GilbertElliottChannel::transmit(BitSpan bits)
+{
+  size_t pos = 0;
+
+  while (pos < bits.size())
+  {
+    if (runRemaining == 0)
+    {
+      inBadState = !inBadState;
+      runRemaining = sampleRunLength();
+    }
+
+    // Corrupt the whole part of the run that falls inside this frame at once
+    size_t length = static_cast<size_t>(std::min<uint64_t>(runRemaining, bits.size() - pos));
+    (inBadState ? badNoise : goodNoise).apply(bits.subspan(pos, length), rng);
+
+    pos += length;
+    runRemaining -= length;
+  }
+}
+
+double GilbertElliottChannel::getBadStateProbability() const
+{
+  double total = leaveGood.getProbability() + leaveBad.getProbability();
+  if (total == 0.0)
+    return 0.0;
+  return leaveGood.getProbability() / total;
+}
+
+double GilbertElliottChannel::getErrorRate() const
+{
+  double bad = getBadStateProbability();
+  return (1.0 - bad) * goodNoise.getProbability() + bad * badNoise.getProbability();
+}
@@ -1,169 +1,323 @@
 #include "../include/hamming_code.h"
+#include "../include/hamming_tables.h"
+#include "../include/cpu_features.h"
+#include <algorithm>
 
-std::vector<bool> HammingCode::encode(const std::vector<bool> &input)
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAMMING_HAVE_AVX2_KERNELS 1
+#endif
+
+namespace
 {
-  std::vector<bool> encoded;
+  /*
+   * Bit-sliced decoding: lane word k holds bit k of many codewords, one
+   * codeword per bit position. The parity checks and corrections are then a
+   * handful of boolean operations on whole words, with no per-codeword
+   * branches or lookups.
+   */
+  inline void correctSlices(const uint64_t lanes[7], uint64_t data[4], uint64_t &corrected)
+  {
+    // Lanes hold codeword positions 1..7: p1, p2, d1, p3, d2, d3, d4
+    uint64_t s1 = lanes[0] ^ lanes[2] ^ lanes[4] ^ lanes[6];
+    uint64_t s2 = lanes[1] ^ lanes[2] ^ lanes[5] ^ lanes[6];
+    uint64_t s3 = lanes[3] ^ lanes[4] ^ lanes[5] ^ lanes[6];
+
+    // Flip the data bit whose position equals the syndrome; the AVX2 kernel mirrors this
+    data[0] = lanes[2] ^ (s1 & s2 & ~s3);
+    data[1] = lanes[4] ^ (s1 & ~s2 & s3);
+    data[2] = lanes[5] ^ (~s1 & s2 & s3);
+    data[3] = lanes[6] ^ (s1 & s2 & s3);
+    corrected = s1 | s2 | s3;
+  }
+
+  // Transpose an 8x8 bit matrix: bit 8r + c moves to bit 8c + r
+  inline uint64_t transpose8(uint64_t x)
+  {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+  }
 
-  // Pad the input if necessary to make it a multiple of 4
-  std::vector<bool> paddedBits = input;
-  while (paddedBits.size() % 4 != 0)
+  // Spread eight 7-bit fields into the low bits of eight bytes
+  inline uint64_t spreadSevens(uint64_t x)
   {
-    paddedBits.push_back(false);
+    x = (x & 0x000000000FFFFFFFULL) | ((x & 0x00FFFFFFF0000000ULL) << 4);
+    x = (x & 0x00003FFF00003FFFULL) | ((x & 0x0FFFC0000FFFC000ULL) << 2);
+    x = (x & 0x007F007F007F007FULL) | ((x & 0x3F803F803F803F80ULL) << 1);
+    return x;
   }
 
-  // Reserve space for the encoded data
-  encoded.reserve(paddedBits.size() * 7 / 4); // Each 4 bits become 7 bits
+  // Gather the low nibbles of eight bytes into 32 bits
+  inline uint32_t gatherNibbles(uint64_t x)
+  {
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+    return static_cast<uint32_t>(x);
+  }
 
-  // Process 4 bits at a time
-  for (size_t i = 0; i < paddedBits.size(); i += 4)
+  // Transpose an 8x8 byte matrix held in eight words: byte c of w[r] swaps with byte r of w[c]
+  inline void transposeBytes(uint64_t w[8])
   {
-    std::vector<bool> dataBlock(4);
-    for (int j = 0; j < 4; j++)
+    for (int i = 0; i < 4; i++)
+    {
+      uint64_t t = ((w[i] >> 32) ^ w[i + 4]) & 0x00000000FFFFFFFFULL;
+      w[i] ^= t << 32;
+      w[i + 4] ^= t;
+    }
+    for (int i = 0; i < 8; i += 4)
     {
-      dataBlock[j] = paddedBits[i + j];
+      for (int j = i; j < i + 2; j++)
+      {
+        uint64_t t = ((w[j] >> 16) ^ w[j + 2]) & 0x0000FFFF0000FFFFULL;
+        w[j] ^= t << 16;
+        w[j + 2] ^= t;
+      }
     }
+    for (int i = 0; i < 8; i += 2)
+    {
+      uint64_t t = ((w[i] >> 8) ^ w[i + 1]) & 0x00FF00FF00FF00FFULL;
+      w[i] ^= t << 8;
+      w[i + 1] ^= t;
+    }
+  }
 
-    // Encode the 4-bit block using Hamming(7,4)
-    std::vector<bool> encodedBlock = encodeHamming74(dataBlock);
+  // Decode the 64 codewords starting at block first; returns a mask with bit i
+  // set when codeword first + i was corrected
+  uint64_t decodeSliced64(ConstBitSpan input, size_t first, BitSpan output)
+  {
+    uint64_t w[8];
+    for (int g = 0; g < 8; g++)
+    {
+      // Row g: bit-plane bytes of codewords 8g..8g+7; after transposeBytes, w[k] is lane k
+      w[g] = transpose8(spreadSevens(input.getBits((first + 8 * g) * 7, 56)));
+    }
+    transposeBytes(w);
+
+    uint64_t data[4];
+    uint64_t corrected;
+    correctSlices(w, data, corrected);
 
-    // Add the encoded block to the result
-    encoded.insert(encoded.end(), encodedBlock.begin(), encodedBlock.end());
+    uint64_t rows[8] = {data[0], data[1], data[2], data[3], 0, 0, 0, 0};
+    transposeBytes(rows);
+    for (int g = 0; g < 8; g++)
+    {
+      output.setBits((first + 8 * g) * 4, 32, gatherNibbles(transpose8(rows[g])));
+    }
+
+    return corrected;
   }
 
-  return encoded;
-}
+#ifdef HAMMING_HAVE_AVX2_KERNELS
+  // Decode the 256 codewords starting at block first; bit i of corrected[j]
+  // is set when codeword first + 64j + i was corrected
+  __attribute__((target("avx2,bmi2"))) void decodeSliced256(ConstBitSpan input, size_t first, BitSpan output,
+                                                            uint64_t corrected[4])
+  {
+    // One codeword per byte
+    alignas(32) uint64_t bytes[32];
+    for (int g = 0; g < 32; g++)
+    {
+      bytes[g] = _pdep_u64(input.getBits((first + 8 * g) * 7, 56), 0x7F7F7F7F7F7F7F7FULL);
+    }
 
-std::vector<bool> HammingCode::encodeHamming74(const std::vector<bool> &dataBits)
-{
-  // Hamming(7,4) encoding
-  // dataBits: [d1, d2, d3, d4]
-  // encoded: [p1, p2, d1, p3, d2, d3, d4]
-  // where p1, p2, p3 are parity bits
+    // Gather bit k of 32 codewords at a time with a shift and a byte movemask
+    alignas(32) uint32_t lanes[7][8];
+    for (int v = 0; v < 8; v++)
+    {
+      __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i *>(bytes + 4 * v));
+      for (int k = 0; k < 7; k++)
+      {
+        lanes[k][v] = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(x, 7 - k)));
+      }
+    }
 
-  std::vector<bool> encoded(7);
+    __m256i laneVectors[7];
+    for (int k = 0; k < 7; k++)
+    {
+      laneVectors[k] = _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes[k]));
+    }
 
-  // Data bits
-  encoded[2] = dataBits[0]; // d1
-  encoded[4] = dataBits[1]; // d2
-  encoded[5] = dataBits[2]; // d3
-  encoded[6] = dataBits[3]; // d4
+    const __m256i ones = _mm256_set1_epi32(-1);
+    __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(laneVectors[0], laneVectors[2]), _mm256_xor_si256(laneVectors[4], laneVectors[6]));
+    __m256i s2 = _mm256_xor_si256(_mm256_xor_si256(laneVectors[1], laneVectors[2]), _mm256_xor_si256(laneVectors[5], laneVectors[6]));
+    __m256i s3 = _mm256_xor_si256(_mm256_xor_si256(laneVectors[3], laneVectors[4]), _mm256_xor_si256(laneVectors[5], laneVectors[6]));
+    __m256i n1 = _mm256_xor_si256(s1, ones);
+    __m256i n2 = _mm256_xor_si256(s2, ones);
+    __m256i n3 = _mm256_xor_si256(s3, ones);
+
+    alignas(32) uint32_t data[4][8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(data[0]), _mm256_xor_si256(laneVectors[2], _mm256_and_si256(_mm256_and_si256(s1, s2), n3)));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(data[1]), _mm256_xor_si256(laneVectors[4], _mm256_and_si256(_mm256_and_si256(s1, n2), s3)));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(data[2]), _mm256_xor_si256(laneVectors[5], _mm256_and_si256(_mm256_and_si256(n1, s2), s3)));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(data[3]), _mm256_xor_si256(laneVectors[6], _mm256_and_si256(_mm256_and_si256(s1, s2), s3)));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(corrected), _mm256_or_si256(_mm256_or_si256(s1, s2), s3));
+
+    // Expand each 32-bit lane mask back to one byte per codeword and merge the nibbles
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i select = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+    for (int v = 0; v < 8; v++)
+    {
+      __m256i nibbles = _mm256_setzero_si256();
+      for (int k = 0; k < 4; k++)
+      {
+        __m256i mask = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(data[k][v])), spread);
+        __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(mask, select), select);
+        nibbles = _mm256_or_si256(nibbles, _mm256_and_si256(set, _mm256_set1_epi8(static_cast<char>(1 << k))));
+      }
+
+      alignas(32) uint64_t rows[4];
+      _mm256_store_si256(reinterpret_cast<__m256i *>(rows), nibbles);
+      for (int g = 0; g < 4; g++)
+      {
+        output.setBits((first + 32 * v + 8 * g) * 4, 32, _pext_u64(rows[g], 0x0F0F0F0F0F0F0F0FULL));
+      }
+    }
+  }
+#endif
 
-  // Calculate parity bits
-  // p1 covers bits 1, 3, 5, 7 (0-based: 0, 2, 4, 6)
-  encoded[0] = encoded[2] ^ encoded[4] ^ encoded[6];
+  // Count the corrections of 64 codewords and record them in status (if any)
+  int recordCorrections(uint64_t corrected, CodewordStatus *status)
+  {
+    if (status)
+    {
+      for (int i = 0; i < 64; i++)
+      {
+        status[i] = {static_cast<int>((corrected >> i) & 1), false};
+      }
+    }
+    return __builtin_popcountll(corrected);
+  }
+}
 
-  // p2 covers bits 2, 3, 6, 7 (0-based: 1, 2, 5, 6)
-  encoded[1] = encoded[2] ^ encoded[5] ^ encoded[6];
+void HammingCode::encode(ConstBitSpan input, BitBuffer &output)
+{
+  // Pad the input with zeros to a multiple of 4 bits; each 4 bits become 7 bits
+  output.resize((input.size() + 3) / 4 * 7);
+  encodeBlocks(input, output);
+}
+
+void HammingCode::encodeBatch(ConstBitSpan messages, BitSpan codewords)
+{
+  batchSize(messages.size(), codewords.size());
+  encodeBlocks(messages, codewords);
+}
 
-  // p3 covers bits 4, 5, 6, 7 (0-based: 3, 4, 5, 6)
-  encoded[3] = encoded[4] ^ encoded[5] ^ encoded[6];
+void HammingCode::encodeBlocks(ConstBitSpan input, BitSpan output)
+{
+  size_t blocks = output.size() / 7;
+  size_t fullBlocks = std::min(blocks, input.size() / 4);
+
+  // Encode 8 full blocks (32 data bits, 56 codeword bits) at a time; a
+  // partial last block is left to the padding loop below
+  size_t b = 0;
+  for (; b + 8 <= fullBlocks; b += 8)
+  {
+    uint32_t data = static_cast<uint32_t>(input.getBits(b * 4, 32));
+    output.setBits(b * 7, 56, Hamming74::encodeWord(data));
+  }
 
-  return encoded;
+  // Encode the remaining blocks one at a time
+  for (; b < blocks; b++)
+  {
+    size_t pos = b * 4;
+    int available = static_cast<int>(std::min<size_t>(4, input.size() - pos));
+    uint8_t dataBlock = static_cast<uint8_t>(input.getBits(pos, available));
+    output.setBits(b * 7, 7, encodeHamming74(dataBlock));
+  }
 }
 
-std::pair<std::vector<bool>, int> HammingCode::decode(const std::vector<bool> &input)
+uint8_t HammingCode::encodeHamming74(uint8_t dataBits)
 {
-  std::vector<bool> decoded;
-  int totalErrorsFixed = 0;
+  return Hamming74::ENCODE[dataBits & 0xF];
+}
 
+int HammingCode::decode(ConstBitSpan input, BitBuffer &output)
+{
   // Ensure the encoded data is a multiple of 7 bits
   if (input.size() % 7 != 0)
   {
-    return {{}, 0}; // Invalid encoded data
+    output.clear();
+    return 0; // Invalid encoded data
   }
 
-  // Reserve space for the decoded data
-  decoded.reserve(input.size() * 4 / 7); // Each 7 bits become 4 bits
+  output.resize(input.size() / 7 * 4); // Each 7 bits become 4 bits
+  return decodeBlocks(input, output, nullptr);
+}
+
+int HammingCode::decodeBatch(ConstBitSpan codewords, ConstBitSpan, BitSpan messages, CodewordStatus *status)
+{
+  batchSize(messages.size(), codewords.size());
+  return decodeBlocks(codewords, messages, status);
+}
+
+int HammingCode::decodeBlocks(ConstBitSpan input, BitSpan output, CodewordStatus *status)
+{
+  size_t blocks = input.size() / 7;
+  int totalErrorsFixed = 0;
 
-  // Process 7 bits at a time
-  for (size_t i = 0; i < input.size(); i += 7)
+  size_t b = 0;
+
+  // Bit-sliced decoding of 256 or 64 codewords at a time
+#ifdef HAMMING_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2() && CpuFeatures::hasBmi2())
   {
-    std::vector<bool> encodedBlock(7);
-    for (int j = 0; j < 7; j++)
+    for (; b + 256 <= blocks; b += 256)
     {
-      encodedBlock[j] = input[i + j];
+      uint64_t corrected[4];
+      decodeSliced256(input, b, output, corrected);
+      for (int j = 0; j < 4; j++)
+      {
+        totalErrorsFixed += recordCorrections(corrected[j], status ? status + b + 64 * j : nullptr);
+      }
     }
+  }
+#endif
+  for (; b + 64 <= blocks; b += 64)
+  {
+    totalErrorsFixed += recordCorrections(decodeSliced64(input, b, output), status ? status + b : nullptr);
+  }
 
-    // Decode the 7-bit block using Hamming(7,4)
-    auto [decodedBlock, errorFixed] = decodeHamming74(encodedBlock);
+  // Decode 8 blocks (56 codeword bits, 32 data bits) at a time, unless the
+  // outcome of each codeword is wanted
+  for (; !status && b + 8 <= blocks; b += 8)
+  {
+    uint64_t codewords = input.getBits(b * 7, 56);
+    output.setBits(b * 4, 32, Hamming74::decodeWord(codewords, totalErrorsFixed));
+  }
 
-    // Add the decoded block to the result
-    decoded.insert(decoded.end(), decodedBlock.begin(), decodedBlock.end());
+  // Decode the remaining blocks one at a time
+  for (; b < blocks; b++)
+  {
+    bool errorFixed = false;
+    uint8_t decodedBlock = decodeHamming74(static_cast<uint8_t>(input.getBits(b * 7, 7)), errorFixed);
+    output.setBits(b * 4, 4, decodedBlock);
 
-    // Update error count
     if (errorFixed)
     {
       totalErrorsFixed++;
     }
+    if (status)
+    {
+      status[b] = {errorFixed ? 1 : 0, false};
+    }
   }
 
-  return {decoded, totalErrorsFixed};
+  return totalErrorsFixed;
 }
 
-std::pair<std::vector<bool>, bool> HammingCode::decodeHamming74(const std::vector<bool> &encodedBlock)
+uint8_t HammingCode::decodeHamming74(uint8_t encodedBlock, bool &errorFixed)
 {
-  // Hamming(7,4) decoding
-  // encodedBlock: [p1, p2, d1, p3, d2, d3, d4]
-  // where p1, p2, p3 are parity bits
-
-  std::vector<bool> decoded(4);
-  bool errorFixed = false;
-
-  // Extract received data bits
-  bool receivedD1 = encodedBlock[2];
-  bool receivedD2 = encodedBlock[4];
-  bool receivedD3 = encodedBlock[5];
-  bool receivedD4 = encodedBlock[6];
-
-  // Extract received parity bits
-  bool receivedP1 = encodedBlock[0];
-  bool receivedP2 = encodedBlock[1];
-  bool receivedP3 = encodedBlock[3];
-
-  // Calculate parity checks (XOR should be 0 if no errors)
-  bool p1Check = receivedP1 ^ receivedD1 ^ receivedD2 ^ receivedD4;
-  bool p2Check = receivedP2 ^ receivedD1 ^ receivedD3 ^ receivedD4;
-  bool p3Check = receivedP3 ^ receivedD2 ^ receivedD3 ^ receivedD4;
-
-  // Calculate syndrome
-  int syndrome = (p3Check ? 4 : 0) | (p2Check ? 2 : 0) | (p1Check ? 1 : 0);
-
-  // Copy received data bits initially
-  decoded[0] = receivedD1;
-  decoded[1] = receivedD2;
-  decoded[2] = receivedD3;
-  decoded[3] = receivedD4;
-
-  // Apply error correction based on syndrome
-  if (syndrome != 0)
-  {
-    errorFixed = true;
-
-    switch (syndrome)
-    {
-    case 1: // Error in p1
-      // No data bit affected
-      break;
-    case 2: // Error in p2
-      // No data bit affected
-      break;
-    case 3: // Error in d1
-      decoded[0] = !receivedD1;
-      break;
-    case 4: // Error in p3
-      // No data bit affected
-      break;
-    case 5: // Error in d2
-      decoded[1] = !receivedD2;
-      break;
-    case 6: // Error in d3
-      decoded[2] = !receivedD3;
-      break;
-    case 7: // Error in d4
-      decoded[3] = !receivedD4;
-      break;
-    }
-  }
-
-  return {decoded, errorFixed};
+  // The table holds the corrected data nibble and a flag for nonzero syndromes
+  uint8_t entry = Hamming74::DECODE[encodedBlock & 0x7F];
+  errorFixed = (entry & Hamming74::CORRECTED) != 0;
+  return entry & Hamming74::DATA_MASK;
 }
@@ -10,11 +10,16 @@
 #include <chrono>
 
 #include "../include/coding_strategy.h"
+#include "../include/bit_buffer.h"
 #include "../include/coding_factory.h"
+#include "../include/segmented_code.h"
 #include "../include/utils.h"
 #include "../include/channel.h"
+#include "../include/gilbert_elliott_channel.h"
+#include "../include/awgn_channel.h"
 #include "../include/visualizer.h"
 #include "../include/metrics.h"
+#include "../include/sweep_engine.h"
 
 // Function to display a welcome message and instructions
 void displayWelcome()
@@ -111,7 +116,10 @@ void runSimulation()
 
   // Select coding strategy
   std::string strategyName = selectCodingStrategy();
-  std::shared_ptr<CodingStrategy> codingStrategy = CodingFactory::getInstance().createStrategy(strategyName);
+
+  // Frame the message so it fits any block length
+  std::unique_ptr<CodingStrategy> codingStrategy =
+      std::make_unique<SegmentedCode>(CodingFactory::getInstance().createStrategy(strategyName));
 
   // Get error rate
   double errorRate = getErrorRate();
@@ -121,33 +129,37 @@ void runSimulation()
 
   // Step 1: Convert message to bits
   metrics.startOperation("String to Bits Conversion");
-  std::vector<bool> originalBits = Utils::stringToBits(message);
+  BitBuffer originalBits;
+  Utils::stringToBits(message, originalBits);
   metrics.endOperation("String to Bits Conversion");
 
   std::cout << "\n=== SIMULATION RESULTS ===\n\n";
 
   // Display original bits
-  visualizer.visualizeBits(originalBits, "Original bits", std::cout, 8);
+  visualizer.visualizeBits(originalBits.toVector(), "Original bits", std::cout, 8);
 
   // Step 2: Encode the message
+  BitBuffer encodedBits;
   metrics.startOperation("Encoding");
-  std::vector<bool> encodedBits = codingStrategy->encode(originalBits);
+  codingStrategy->encode(originalBits, encodedBits);
   metrics.endOperation("Encoding");
   metrics.recordTransmission(originalBits.size(), encodedBits.size());
 
-  visualizer.visualizeBits(encodedBits, "Encoded bits (" + strategyName + ")", std::cout,
+  visualizer.visualizeBits(encodedBits.toVector(), "Encoded bits (" + strategyName + ")", std::cout,
                            strategyName.find("Hamming") != std::string::npos ? 7 : 8);
 
   // Step 3: Transmit through noisy channel
+  BitBuffer transmittedBits(encodedBits);
   metrics.startOperation("Channel Transmission");
-  std::vector<bool> transmittedBits = channel.transmit(encodedBits);
+  channel.transmit(transmittedBits);
   metrics.endOperation("Channel Transmission");
 
   // Count errors introduced by channel
-  int channelErrors = Utils::countDifferences(encodedBits, transmittedBits);
+  int channelErrors = static_cast<int>(Utils::countDifferences(encodedBits, transmittedBits));
   metrics.recordErrors(encodedBits, transmittedBits);
 
-  visualizer.visualizeDifferences(encodedBits, transmittedBits, "Transmission with noise", std::cout,
+  visualizer.visualizeDifferences(encodedBits.toVector(), transmittedBits.toVector(),
+                                  "Transmission with noise", std::cout,
                                   strategyName.find("Hamming") != std::string::npos ? 7 : 8);
 
   std::cout << "Bit errors introduced: " << channelErrors << " of "
@@ -157,8 +169,9 @@ void runSimulation()
             << "%)\n\n";
 
   // Step 4: Decode the received message
+  BitBuffer decodedBits;
   metrics.startOperation("Decoding");
-  auto [decodedBits, errorsFixed] = codingStrategy->decode(transmittedBits);
+  int errorsFixed = codingStrategy->decode(transmittedBits, decodedBits);
   metrics.endOperation("Decoding");
   metrics.recordErrorCorrection(channelErrors, errorsFixed);
 
@@ -189,9 +202,150 @@ void runSimulation()
   visualizer.drawSeparator();
 }
 
+// Function to print command-line usage for the batch sweep mode
+void printSweepUsage()
+{
+  std::cout << "Usage: sat-com --sweep [options]\n\n";
+  std::cout << "Runs a headless Monte-Carlo BER/FER sweep.\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  --code NAME              Coding strategy to sweep (repeatable, default: all listed);\n";
+  std::cout << "                           also RS(n,k) or BCH(m=M,t=T[,shorten=S][,poly=P]),\n";
+  std::cout << "                           P = 0x187 (m=8) or 0x1002D (m=16) besides the default\n";
+  std::cout << "  --rates R1,R2,...        Channel bit error rates (default: 1e-1 down to 1e-3)\n";
+  std::cout << "  --frames N               Codewords per point (default: 100000)\n";
+  std::cout << "  --max-frame-errors N     Stop a point after N frame errors (default: never)\n";
+  std::cout << "  --threads N              Worker threads (default: all cores)\n";
+  std::cout << "  --burst PGB,PBG,EGOOD    Use a Gilbert-Elliott burst channel; the swept rate\n";
+  std::cout << "                           is the bad-state error rate\n";
+  std::cout << "  --awgn bpsk|qpsk         Use an AWGN channel with hard decisions; the swept\n";
+  std::cout << "                           values are Eb/N0 in dB (default: 0 to 8)\n";
+  std::cout << "  --seed N                 Random seed; results do not depend on --threads (default: 1)\n";
+  std::cout << "  --csv                    Print comma-separated values\n";
+}
+
+// Function to run the batch sweep mode; returns the process exit code
+int runSweep(int argc, char *argv[])
+{
+  SweepConfig config;
+  config.errorRates = {1e-1, 5e-2, 2e-2, 1e-2, 5e-3, 2e-3, 1e-3};
+  bool csv = false;
+  bool ratesGiven = false;
+
+  for (int i = 2; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if (arg == "--code" && hasValue)
+    {
+      config.strategies.push_back(argv[++i]);
+    }
+    else if (arg == "--rates" && hasValue)
+    {
+      config.errorRates.clear();
+      ratesGiven = true;
+      std::stringstream ss(argv[++i]);
+      std::string item;
+      while (std::getline(ss, item, ','))
+      {
+        config.errorRates.push_back(std::stod(item));
+      }
+    }
+    else if (arg == "--frames" && hasValue)
+    {
+      config.framesPerPoint = std::stoull(argv[++i]);
+    }
+    else if (arg == "--max-frame-errors" && hasValue)
+    {
+      config.maxFrameErrors = std::stoull(argv[++i]);
+    }
+    else if (arg == "--threads" && hasValue)
+    {
+      config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+    }
+    else if (arg == "--burst" && hasValue)
+    {
+      std::vector<double> params;
+      std::stringstream ss(argv[++i]);
+      std::string item;
+      while (std::getline(ss, item, ','))
+      {
+        params.push_back(std::stod(item));
+      }
+      if (params.size() != 3)
+      {
+        printSweepUsage();
+        return 1;
+      }
+      config.channelFactory = [params](double errorRate, double)
+      {
+        return std::make_unique<GilbertElliottChannel>(params[0], params[1], params[2], errorRate);
+      };
+    }
+    else if (arg == "--awgn" && hasValue)
+    {
+      std::string name = argv[++i];
+      if (name != "bpsk" && name != "qpsk")
+      {
+        printSweepUsage();
+        return 1;
+      }
+      AwgnChannel::Modulation modulation = name == "bpsk" ? AwgnChannel::Modulation::BPSK
+                                                          : AwgnChannel::Modulation::QPSK;
+      config.channelFactory = [modulation](double ebN0Db, double codeRate)
+      {
+        return std::make_unique<AwgnChannel>(ebN0Db, codeRate, modulation);
+      };
+      if (!ratesGiven)
+      {
+        config.errorRates = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+      }
+    }
+    else if (arg == "--seed" && hasValue)
+    {
+      config.seed = std::stoull(argv[++i]);
+    }
+    else if (arg == "--csv")
+    {
+      csv = true;
+    }
+    else
+    {
+      printSweepUsage();
+      return 1;
+    }
+  }
+
+  SweepEngine engine(config);
+  SweepEngine::printHeader(std::cout, csv);
+  engine.run([csv](const SweepPoint &point)
+             { SweepEngine::printPoint(point, std::cout, csv); });
+
+  return 0;
+}
+
 // Main function
-int main()
+int main(int argc, char *argv[])
 {
+  if (argc > 1)
+  {
+    if (std::string(argv[1]) == "--sweep")
+    {
+      try
+      {
+        return runSweep(argc, argv);
+      }
+      catch (const std::exception &e)
+      {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+      }
+    }
+
+    printSweepUsage();
+    return 1;
+  }
+
   displayWelcome();
 
   bool running = true;
@@ -1,6 +1,7 @@
 #include "../include/metrics.h"
 #include <iomanip>
 #include <algorithm>
+#include "../include/utils.h"
 
 Metrics::Metrics()
 {
@@ -51,6 +52,14 @@ void Metrics::recordErrors(const std::vector<bool> &originalBits,
   }
 }
 
+void Metrics::recordErrors(ConstBitSpan originalBits, ConstBitSpan receivedBits)
+{
+  size_t minSize = std::min(originalBits.size(), receivedBits.size());
+
+  totalBits += static_cast<int>(minSize);
+  errorBits += static_cast<int>(Utils::countDifferences(originalBits, receivedBits, minSize));
+}
+
 void Metrics::recordErrorCorrection(int detected, int corrected)
 {
   errorsDetected += detected;
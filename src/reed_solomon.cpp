@@ -1,169 +1,386 @@
 #include "../include/reed_solomon.h"
+#include "../include/cpu_features.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 
-ReedSolomon::ReedSolomon(int symbolSize, int dataSize, int paritySize)
-    : symbolSize(symbolSize), dataSize(dataSize), paritySize(paritySize)
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RS_HAVE_AVX2_KERNELS 1
+#endif
+
+namespace
 {
+  // Codewords encoded side by side by the lane kernels
+  const size_t LANE_GROUP = CodewordBatch::LANE_GROUP;
 
-  // Limit symbol size to 8 bits for simplicity
-  if (symbolSize > 8)
+  // Dirty codewords in a lane group needed for the lane Chien search to pay off
+  const size_t CHIEN_LANE_MIN = 4;
+
+  // Index of symbol 0 of codeword b in a stream of blocks of depth interleaved codewords
+  size_t codewordStart(size_t b, size_t depth, size_t blockSize)
   {
-    throw std::invalid_argument("Symbol size must be <= 8 bits");
+    return (b / depth) * blockSize + b % depth;
   }
 
-  fieldSize = 1 << symbolSize; // 2^symbolSize
-
-  // Initialize Galois Field lookup tables
-  initTables();
-}
+  // Copy count symbols of one codeword out of a stream, where they are depth apart
+  void readStrided(const uint8_t *stream, size_t depth, int count, uint8_t *symbols)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      symbols[i] = stream[i * depth];
+    }
+  }
 
-void ReedSolomon::initTables()
-{
-  // Create exponential and logarithm tables for GF(2^m)
-  expTable.resize(fieldSize * 2); // Double size to avoid modulo in multiplication
-  logTable.resize(fieldSize);
-
-  // For GF(2^8), the primitive polynomial is x^8 + x^4 + x^3 + x^2 + 1 (0x11D)
-  // For smaller fields, we use appropriate primitive polynomials
-  int primitive_poly = 0;
-  switch (symbolSize)
-  {
-  case 3:
-    primitive_poly = 0xB;
-    break; // x^3 + x + 1
-  case 4:
-    primitive_poly = 0x13;
-    break; // x^4 + x + 1
-  case 8:
-    primitive_poly = 0x11D;
-    break; // x^8 + x^4 + x^3 + x^2 + 1
-  default:
-    primitive_poly = (1 << symbolSize) | 1; // Default: x^m + 1
+  // Inverse of readStrided
+  void writeStrided(const uint8_t *symbols, int count, size_t depth, uint8_t *stream)
+  {
+    for (int i = 0; i < count; i++)
+    {
+      stream[i * depth] = symbols[i];
+    }
   }
 
-  int x = 1;
+  /*
+   * Table-driven LFSR on a register packed eight symbols per word. Each data
+   * symbol costs one row lookup, a one-byte shift of the register and a XOR
+   * per word. Bytes past paritySize stay zero, since the rows are zero there.
+   */
+  template <int Words>
+  void lfsrWords(const uint8_t *data, int dataSize, const uint64_t *rows, int rowWords, uint64_t *reg)
+  {
+    const int words = Words > 0 ? Words : rowWords;
+    for (int w = 0; w < words; w++)
+    {
+      reg[w] = 0;
+    }
+
+    for (int i = 0; i < dataSize; i++)
+    {
+      const uint64_t *row = rows + static_cast<size_t>(data[i] ^ (reg[0] & 0xFF)) * words;
+      for (int w = 0; w + 1 < words; w++)
+      {
+        reg[w] = ((reg[w] >> 8) | (reg[w + 1] << 56)) ^ row[w];
+      }
+      reg[words - 1] = (reg[words - 1] >> 8) ^ row[words - 1];
+    }
+  }
 
-  for (int i = 0; i < fieldSize - 1; i++)
+#ifdef RS_HAVE_AVX2_KERNELS
+  /*
+   * LFSR encoder for 32 codewords at once, one codeword per byte lane. The
+   * multiplication of the feedback bytes by a generator coefficient c uses
+   * two 16-entry tables, c * lo and c * (hi << 4), looked up with pshufb.
+   */
+  __attribute__((target("avx2"))) void encodeLanesAvx2(const uint8_t *data, uint8_t *parity, size_t stride,
+                                                       int dataSize, int paritySize, const uint8_t *nibbleTables)
   {
-    expTable[i] = x;
-    logTable[x] = i;
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+
+    for (int j = 0; j < paritySize; j++)
+    {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(parity + j * stride), _mm256_setzero_si256());
+    }
+
+    for (int i = 0; i < dataSize; i++)
+    {
+      __m256i feedback = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i * stride)),
+                                          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(parity)));
+      __m256i lo = _mm256_and_si256(feedback, lowMask);
+      __m256i hi = _mm256_and_si256(_mm256_srli_epi16(feedback, 4), lowMask);
+
+      for (int j = 0; j < paritySize; j++)
+      {
+        const __m128i *tables = reinterpret_cast<const __m128i *>(nibbleTables + 32 * j);
+        __m256i product = _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(tables)), lo),
+                                           _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(tables + 1)), hi));
+        if (j + 1 < paritySize)
+        {
+          product = _mm256_xor_si256(product, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(parity + (j + 1) * stride)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(parity + j * stride), product);
+      }
+    }
+  }
 
-    // Multiply by x
-    x <<= 1;
+  /*
+   * Horner evaluation of 32 remainders at the generator roots
+   * beta^(firstRoot + i), i = 0 .. count - 1, one codeword per byte lane:
+   * S_i = S_i * beta^(firstRoot + i) + R_k for every remainder symbol R_k,
+   * with the constant multiplications done by nibble shuffles.
+   */
+  __attribute__((target("avx2"))) void syndromesLanesAvx2(const uint8_t *remainders, uint8_t *syndromes, size_t stride,
+                                                          int count, const uint8_t *nibbleTables)
+  {
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
 
-    // If overflow, reduce using the primitive polynomial
-    if (x & fieldSize)
+    for (int i = 0; i < count; i++)
     {
-      x ^= primitive_poly;
+      const __m128i *tables = reinterpret_cast<const __m128i *>(nibbleTables + 32 * i);
+      __m256i lowTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(tables));
+      __m256i highTable = _mm256_broadcastsi128_si256(_mm_loadu_si128(tables + 1));
+
+      __m256i acc = _mm256_setzero_si256();
+      for (int k = 0; k < count; k++)
+      {
+        __m256i product = _mm256_xor_si256(_mm256_shuffle_epi8(lowTable, _mm256_and_si256(acc, lowMask)),
+                                           _mm256_shuffle_epi8(highTable, _mm256_and_si256(_mm256_srli_epi16(acc, 4), lowMask)));
+        acc = _mm256_xor_si256(product, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(remainders + k * stride)));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(syndromes + i * stride), acc);
     }
   }
 
-  // 0 is not in the multiplicative group
-  logTable[0] = 0;
+  // Multiply every byte of v by the constant whose nibble tables are at tables
+  __attribute__((target("avx2"))) inline __m256i mulNibbles(__m256i v, const uint8_t *tables)
+  {
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+    const __m128i *halves = reinterpret_cast<const __m128i *>(tables);
+    return _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(halves)),
+                                                _mm256_and_si256(v, lowMask)),
+                            _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(halves + 1)),
+                                                _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask)));
+  }
+
+  /*
+   * Chien search of 32 locators at once, one per byte lane. Term k holds
+   * Lambda_k * x^k at the current codeword index; stepping to the next
+   * index multiplies it by the constant beta^k. Bit l of roots[j] is set
+   * when locator l vanishes at codeword index j.
+   */
+  __attribute__((target("avx2"))) void chienLanesAvx2(const uint8_t *locators, size_t stride, int degree, int n,
+                                                      const uint8_t *startTables, const uint8_t *stepTables,
+                                                      uint32_t *roots)
+  {
+    __m256i terms[256];
+    for (int k = 1; k <= degree; k++)
+    {
+      __m256i lambda = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(locators + k * stride));
+      terms[k - 1] = mulNibbles(lambda, startTables + 32 * (k - 1));
+    }
+
+    const __m256i constant = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(locators));
+    for (int j = 0; j < n; j++)
+    {
+      __m256i sum = constant;
+      for (int k = 0; k < degree; k++)
+      {
+        sum = _mm256_xor_si256(sum, terms[k]);
+        terms[k] = mulNibbles(terms[k], stepTables + 32 * k);
+      }
+      roots[j] = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(sum, _mm256_setzero_si256())));
+    }
+  }
+#endif
 
-  // Fill in the extended exponential table
-  for (int i = fieldSize - 1; i < 2 * fieldSize - 1; i++)
+  int gcd(int a, int b)
   {
-    expTable[i] = expTable[i - (fieldSize - 1)];
+    while (b != 0)
+    {
+      int r = a % b;
+      a = b;
+      b = r;
+    }
+    return a;
   }
 }
 
-uint8_t ReedSolomon::gfMul(uint8_t a, uint8_t b)
+ReedSolomon::ReedSolomon(int symbolSize, int dataSize, int paritySize)
+    : ReedSolomon(symbolSize, dataSize, paritySize, GaloisField::defaultPolynomial(symbolSize), 0, 1, 1)
 {
-  if (a == 0 || b == 0)
-    return 0;
-  return expTable[(logTable[a] + logTable[b]) % (fieldSize - 1)];
 }
 
-uint8_t ReedSolomon::gfDiv(uint8_t a, uint8_t b)
+ReedSolomon::ReedSolomon(int symbolSize, int dataSize, int paritySize, int fieldPolynomial,
+                         int firstRoot, int rootStep, int interleave)
+    : symbolSize(symbolSize), dataSize(dataSize), paritySize(paritySize), interleave(interleave),
+      fieldPolynomial(fieldPolynomial), firstRoot(firstRoot), rootStep(rootStep)
 {
-  if (a == 0) return 0;
-  if (b == 0) throw std::domain_error("Division by zero");
-  return expTable[(logTable[a] + (fieldSize - 1) - logTable[b]) % (fieldSize - 1)];
+
+  // Limit symbol size to 8 bits for simplicity
+  if (symbolSize < 2 || symbolSize > 8)
+  {
+    throw std::invalid_argument("Symbol size must be between 2 and 8 bits (ReedSolomon16 covers GF(2^16))");
+  }
+
+  fieldSize = 1 << symbolSize; // 2^symbolSize
+
+  if (dataSize < 1 || paritySize < 1 || dataSize + paritySize > fieldSize - 1)
+  {
+    throw std::invalid_argument("Codeword length must be at most 2^symbolSize - 1 symbols");
+  }
+
+  if (interleave < 1)
+  {
+    throw std::invalid_argument("Interleave depth must be at least 1");
+  }
+
+  if (firstRoot < 0 || rootStep < 1 || gcd(rootStep, fieldSize - 1) != 1)
+  {
+    throw std::invalid_argument("Generator root step must be coprime to 2^symbolSize - 1");
+  }
+
+  // Galois Field lookup tables, built at compile time
+  field = &GaloisField::get(symbolSize, fieldPolynomial);
+  corrector = RsCorrector<uint8_t>(*field, dataSize, paritySize, firstRoot, rootStep);
+  initEncoder();
+
+  // Scratch of the lane kernels, sized once per code
+  laneData.resize(LANE_GROUP, dataSize);
+  laneParity.resize(LANE_GROUP, paritySize);
+  laneReceived.resize(LANE_GROUP, dataSize + paritySize);
+  laneSyndromes.resize(LANE_GROUP, paritySize);
+  laneLocators.resize(LANE_GROUP, paritySize + 1);
+  laneDegrees.resize(LANE_GROUP);
+  rootMasks.resize(dataSize + paritySize);
+  laneRoots.resize(LANE_GROUP * paritySize);
+  laneRootCounts.resize(LANE_GROUP);
 }
 
-uint8_t ReedSolomon::gfInv(uint8_t a)
+void ReedSolomon::initEncoder()
 {
-  if (a == 0)
-    throw std::domain_error("Cannot invert 0 in Galois Field");
-  return expTable[(fieldSize - 1) - logTable[a]];
+  generator = generatePolynomial();
+
+  rowWords = (paritySize + 7) / 8;
+  parityRows.assign(static_cast<size_t>(fieldSize) * rowWords, 0);
+  for (int v = 0; v < fieldSize; v++)
+  {
+    for (int j = 0; j < paritySize; j++)
+    {
+      uint64_t product = gfMul(static_cast<uint8_t>(v), generator[j + 1]);
+      parityRows[v * rowWords + j / 8] |= product << (8 * (j % 8));
+    }
+  }
+
+  nibbleTables.resize(32 * static_cast<size_t>(paritySize));
+  for (int j = 0; j < paritySize; j++)
+  {
+    for (int x = 0; x < 16; x++)
+    {
+      // Products with symbols that do not exist in smaller fields are never looked up
+      nibbleTables[32 * j + x] = x < fieldSize ? gfMul(static_cast<uint8_t>(x), generator[j + 1]) : 0;
+      nibbleTables[32 * j + 16 + x] = (x << 4) < fieldSize ? gfMul(static_cast<uint8_t>(x << 4), generator[j + 1]) : 0;
+    }
+  }
+
+  syndromeNibbleTables.resize(32 * static_cast<size_t>(paritySize));
+  for (int i = 0; i < paritySize; i++)
+  {
+    for (int x = 0; x < 16; x++)
+    {
+      uint8_t root = static_cast<uint8_t>(field->exp[rootLog(i)]);
+      syndromeNibbleTables[32 * i + x] = x < fieldSize ? gfMul(static_cast<uint8_t>(x), root) : 0;
+      syndromeNibbleTables[32 * i + 16 + x] = (x << 4) < fieldSize ? gfMul(static_cast<uint8_t>(x << 4), root) : 0;
+    }
+  }
+
+  // Codeword index j is the coefficient of x^(n-1-j), tested with x = beta^-(n-1-j)
+  const int order = fieldSize - 1;
+  const int n = dataSize + paritySize;
+  chienStartTables.resize(32 * static_cast<size_t>(paritySize));
+  chienStepTables.resize(32 * static_cast<size_t>(paritySize));
+  for (int k = 1; k <= paritySize; k++)
+  {
+    int stepLog = static_cast<int>((static_cast<long>(rootStep) * k) % order);
+    uint8_t step = static_cast<uint8_t>(field->exp[stepLog]);
+    uint8_t start = static_cast<uint8_t>(field->exp[(order - static_cast<long>(stepLog) * (n - 1) % order) % order]);
+    for (int x = 0; x < 16; x++)
+    {
+      size_t t = 32 * static_cast<size_t>(k - 1);
+      chienStartTables[t + x] = x < fieldSize ? gfMul(static_cast<uint8_t>(x), start) : 0;
+      chienStartTables[t + 16 + x] = (x << 4) < fieldSize ? gfMul(static_cast<uint8_t>(x << 4), start) : 0;
+      chienStepTables[t + x] = x < fieldSize ? gfMul(static_cast<uint8_t>(x), step) : 0;
+      chienStepTables[t + 16 + x] = (x << 4) < fieldSize ? gfMul(static_cast<uint8_t>(x << 4), step) : 0;
+    }
+  }
 }
 
-uint8_t ReedSolomon::gfPow(uint8_t a, int power)
+int ReedSolomon::rootLog(int i) const
 {
-  if (a == 0) return 0;
-  return expTable[(logTable[a] * power) % (fieldSize - 1)];
+  return static_cast<int>((static_cast<long>(rootStep) * (firstRoot + i)) % (fieldSize - 1));
 }
 
-std::vector<uint8_t> ReedSolomon::bitsToSymbols(const std::vector<bool> &bits)
+void ReedSolomon::setSymbolMaps(std::vector<uint8_t> inputMap, std::vector<uint8_t> outputMap)
 {
-  std::vector<uint8_t> symbols;
-
-  // Make sure we have a multiple of symbolSize bits
-  std::vector<bool> paddedBits = bits;
-  while (paddedBits.size() % symbolSize != 0)
+  if (inputMap.size() != static_cast<size_t>(fieldSize) || outputMap.size() != static_cast<size_t>(fieldSize))
   {
-    paddedBits.push_back(false);
+    throw std::invalid_argument("Symbol maps must have 2^symbolSize entries");
   }
+  this->inputMap = std::move(inputMap);
+  this->outputMap = std::move(outputMap);
+}
+
+uint8_t ReedSolomon::gfMul(uint8_t a, uint8_t b) const
+{
+  return static_cast<uint8_t>(field->mul(a, b));
+}
 
-  // Convert each symbolSize bits to a symbol
-  for (size_t i = 0; i < paddedBits.size(); i += symbolSize)
+void ReedSolomon::bitsToSymbols(ConstBitSpan bits, std::vector<uint8_t> &symbols)
+{
+  // Pad the last symbol with zeros if bits is not a multiple of symbolSize
+  size_t count = (bits.size() + symbolSize - 1) / symbolSize;
+  symbols.resize(count);
+
+  // Convert as many whole symbols as fit in 64 bits at a time
+  const size_t perWord = 64 / symbolSize;
+  const uint64_t mask = (uint64_t(1) << symbolSize) - 1;
+  size_t i = 0;
+  for (; (i + perWord) * symbolSize <= bits.size(); i += perWord)
   {
-    uint8_t symbol = 0;
-    for (int j = 0; j < symbolSize; j++)
+    uint64_t word = bits.getBits(i * symbolSize, static_cast<int>(perWord * symbolSize));
+    for (size_t j = 0; j < perWord; j++)
     {
-      if (paddedBits[i + j])
-      {
-        symbol |= (1 << j);
-      }
+      symbols[i + j] = static_cast<uint8_t>((word >> (j * symbolSize)) & mask);
     }
-    symbols.push_back(symbol);
   }
 
-  return symbols;
+  // Convert the remaining symbols one at a time
+  for (; i < count; i++)
+  {
+    size_t pos = i * symbolSize;
+    int available = static_cast<int>(std::min<size_t>(symbolSize, bits.size() - pos));
+    symbols[i] = static_cast<uint8_t>(bits.getBits(pos, available));
+  }
 }
 
-std::vector<bool> ReedSolomon::symbolsToBits(const std::vector<uint8_t> &symbols)
+void ReedSolomon::symbolsToBits(const std::vector<uint8_t> &symbols, BitSpan bits)
 {
-  std::vector<bool> bits;
-
-  // Convert each symbol to symbolSize bits
-  for (uint8_t symbol : symbols)
+  // Convert as many whole symbols as fit in 64 bits at a time
+  const size_t perWord = 64 / symbolSize;
+  size_t i = 0;
+  for (; i + perWord <= symbols.size(); i += perWord)
   {
-    for (int j = 0; j < symbolSize; j++)
+    uint64_t word = 0;
+    for (size_t j = 0; j < perWord; j++)
     {
-      bits.push_back((symbol & (1 << j)) != 0);
+      word |= static_cast<uint64_t>(symbols[i + j]) << (j * symbolSize);
     }
+    bits.setBits(i * symbolSize, static_cast<int>(perWord * symbolSize), word);
   }
 
-  return bits;
+  // Convert the remaining symbols one at a time
+  for (; i < symbols.size(); i++)
+  {
+    bits.setBits(i * symbolSize, symbolSize, symbols[i]);
+  }
 }
 
 std::vector<uint8_t> ReedSolomon::generatePolynomial()
 {
-  // Generate generator polynomial g(x) = (x-a)(x-a^2)...(x-a^n)
-  // where n is the number of parity symbols
+  // Generate generator polynomial g(x) = (x - b^f)(x - b^(f+1))...(x - b^(f+n-1))
+  // where b = alpha^rootStep, f = firstRoot and n is the number of parity
+  // symbols; coefficients highest degree first
 
   std::vector<uint8_t> poly(1, 1); // Start with g(x) = 1
 
   for (int i = 0; i < paritySize; i++)
   {
-    // Multiply by (x-a^i)
-    std::vector<uint8_t> term(2);
-    term[0] = expTable[i]; // a^i
-    term[1] = 1;           // x
-
-    // Polynomial multiplication
-    std::vector<uint8_t> result(poly.size() + term.size() - 1, 0);
-
+    // Multiply by (x - b^(f+i)), which is (x + b^(f+i)) in GF(2^m)
+    std::vector<uint8_t> result(poly.size() + 1, 0);
     for (size_t j = 0; j < poly.size(); j++)
     {
-      for (size_t k = 0; k < term.size(); k++)
-      {
-        result[j + k] ^= gfMul(poly[j], term[k]);
-      }
+      result[j] ^= poly[j];
+      result[j + 1] ^= gfMul(poly[j], static_cast<uint8_t>(field->exp[rootLog(i)]));
     }
 
     poly = result;
@@ -172,300 +389,485 @@ std::vector<uint8_t> ReedSolomon::generatePolynomial()
   return poly;
 }
 
-std::vector<uint8_t> ReedSolomon::encodeSymbols(const std::vector<uint8_t> &dataSymbols)
+void ReedSolomon::encodeParity(const uint8_t *data, uint8_t *parity) const
 {
-  // Make sure we have the right number of data symbols
-  if (dataSymbols.size() != static_cast<size_t>(dataSize))
+  // Divide data(x) * x^paritySize by g(x); the register holds the remainder.
+  // Fixed register sizes let the compiler keep it in registers.
+  uint64_t reg[32];
+  switch (rowWords)
   {
-    throw std::invalid_argument("Data size mismatch");
+  case 1:
+    lfsrWords<1>(data, dataSize, parityRows.data(), rowWords, reg);
+    break;
+  case 2:
+    lfsrWords<2>(data, dataSize, parityRows.data(), rowWords, reg);
+    break;
+  case 4:
+    lfsrWords<4>(data, dataSize, parityRows.data(), rowWords, reg);
+    break;
+  default:
+    lfsrWords<0>(data, dataSize, parityRows.data(), rowWords, reg);
+    break;
   }
 
-  // Generate the generator polynomial
-  std::vector<uint8_t> genPoly = generatePolynomial();
-
-  // Create message polynomial: x^n * data(x)
-  std::vector<uint8_t> msgPoly(dataSize + paritySize, 0);
-  for (int i = 0; i < dataSize; i++)
+  for (int j = 0; j < paritySize; j++)
   {
-    msgPoly[i] = dataSymbols[i];
+    parity[j] = static_cast<uint8_t>(reg[j / 8] >> (8 * (j % 8)));
   }
+}
 
-  // Perform polynomial division to find the remainder
-  for (int i = 0; i < dataSize; i++)
+void ReedSolomon::encodeParityLanes(const CodewordBatch &data, CodewordBatch &parity) const
+{
+  const size_t lanes = data.lanes();
+  size_t l = 0;
+
+#ifdef RS_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2())
   {
-    if (msgPoly[i] != 0)
+    for (; l + LANE_GROUP <= lanes; l += LANE_GROUP)
     {
-      uint8_t coef = msgPoly[i];
+      encodeLanesAvx2(data.row(0) + l, parity.row(0) + l, data.stride(), dataSize, paritySize, nibbleTables.data());
+    }
+  }
+#endif
 
-      for (size_t j = 0; j < genPoly.size(); j++)
-      {
-        msgPoly[i + j] ^= gfMul(genPoly[j], coef);
-      }
+  // Remaining lanes one codeword at a time
+  uint8_t dataColumn[256];
+  uint8_t parityColumn[256];
+  for (; l < lanes; l++)
+  {
+    for (int i = 0; i < dataSize; i++)
+    {
+      dataColumn[i] = data.at(l, i);
+    }
+    encodeParity(dataColumn, parityColumn);
+    for (int j = 0; j < paritySize; j++)
+    {
+      parity.at(l, j) = parityColumn[j];
     }
   }
+}
 
-  // Create the codeword: data followed by parity
-  std::vector<uint8_t> codeword(dataSize + paritySize);
+bool ReedSolomon::computeSyndromes(const uint8_t *received, uint8_t *syndromes)
+{
+  // r(x) mod g(x) is the parity of the received data XOR the received parity
+  uint8_t remainder[256];
+  encodeParity(received, remainder);
 
-  // Copy data symbols
-  for (int i = 0; i < dataSize; i++)
+  uint8_t any = 0;
+  for (int j = 0; j < paritySize; j++)
   {
-    codeword[i] = dataSymbols[i];
+    remainder[j] ^= received[dataSize + j];
+    any |= remainder[j];
   }
 
-  // Copy parity symbols (from the remainder)
-  for (int i = 0; i < paritySize; i++)
+  if (any == 0)
   {
-    codeword[dataSize + i] = msgPoly[dataSize + i];
+    std::fill(syndromes, syndromes + paritySize, 0);
+    return false;
   }
 
-  return codeword;
+  corrector.syndromesFromRemainder(remainder, syndromes);
+  return true;
 }
 
-std::vector<uint8_t> ReedSolomon::computeSyndrome(const std::vector<uint8_t>& received) {
-    // Compute syndrome values
-    std::vector<uint8_t> syndrome(2 * paritySize, 0);
+void ReedSolomon::syndromesLanes(const CodewordBatch &remainders, CodewordBatch &syndromes)
+{
+  const size_t lanes = remainders.lanes();
+  size_t l = 0;
 
-    for (int i = 0; i < 2 * paritySize; i++) {
-        // Evaluate received polynomial at alpha^i
-        for (size_t j = 0; j < received.size(); j++) {
-            // syndrome[i] = syndrome[i] + received[j] * alpha^(i*j)
-            syndrome[i] ^= gfMul(received[j], gfPow(expTable[1], i * j));
-        }
+#ifdef RS_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2())
+  {
+    for (; l + LANE_GROUP <= lanes; l += LANE_GROUP)
+    {
+      syndromesLanesAvx2(remainders.row(0) + l, syndromes.row(0) + l, remainders.stride(), paritySize,
+                         syndromeNibbleTables.data());
     }
+  }
+#endif
 
-    return syndrome;
+  // Remaining lanes one codeword at a time
+  uint8_t remainderColumn[256];
+  uint8_t syndromeColumn[256];
+  for (; l < lanes; l++)
+  {
+    for (int k = 0; k < paritySize; k++)
+    {
+      remainderColumn[k] = remainders.at(l, k);
+    }
+    corrector.syndromesFromRemainder(remainderColumn, syndromeColumn);
+    for (int i = 0; i < paritySize; i++)
+    {
+      syndromes.at(l, i) = syndromeColumn[i];
+    }
+  }
 }
 
-// New method: Berlekamp-Massey algorithm to find error locator polynomial
-std::vector<uint8_t> ReedSolomon::findErrorLocator(const std::vector<uint8_t>& syndrome) {
-    // Initialize error locator with 1
-    std::vector<uint8_t> errorLocator = {1};
-    std::vector<uint8_t> oldLocator = {1};
-
-    int L = 0; // Current error locator degree
-    int k = 0; // Number of iterations
-    uint8_t delta;
-
-    // Berlekamp-Massey algorithm
-    for (int n = 0; n < paritySize; n++) {
-        // Compute discrepancy
-        delta = syndrome[n];
-        for (int i = 1; i <= L; i++) {
-            if (i < static_cast<int>(errorLocator.size())) {
-                delta ^= gfMul(errorLocator[i], syndrome[n - i]);
-            }
-        }
+int ReedSolomon::findErasures(size_t codeword, int *positions) const
+{
+  if (erasureBuffer.empty())
+  {
+    return 0;
+  }
 
-        // Shift old_locator and append a zero
-        oldLocator.push_back(0);
-
-        if (delta != 0) {
-            if (2 * L <= n) {
-                // Update locator
-                std::vector<uint8_t> newLocator(std::max(errorLocator.size(), oldLocator.size()), 0);
-                for (size_t i = 0; i < errorLocator.size(); i++) {
-                    newLocator[i] ^= errorLocator[i];
-                }
-
-                for (size_t i = 0; i < oldLocator.size(); i++) {
-                    newLocator[i] ^= gfMul(delta, oldLocator[i]);
-                }
-
-                oldLocator = errorLocator;
-                errorLocator = newLocator;
-                L = n + 1 - L;
-            } else {
-                // Update locator
-                std::vector<uint8_t> newLocator(std::max(errorLocator.size(), oldLocator.size()), 0);
-                for (size_t i = 0; i < errorLocator.size(); i++) {
-                    newLocator[i] ^= errorLocator[i];
-                }
-
-                for (size_t i = 0; i < oldLocator.size(); i++) {
-                    newLocator[i] ^= gfMul(delta, oldLocator[i]);
-                }
-
-                errorLocator = newLocator;
-            }
-        }
+  const int n = dataSize + paritySize;
+  uint8_t flags[256];
+  const size_t depth = interleave;
+  readStrided(&erasureBuffer[codewordStart(codeword, depth, depth * n)], depth, n, flags);
 
-        k++;
+  int count = 0;
+  for (int i = 0; i < n; i++)
+  {
+    if (flags[i] != 0)
+    {
+      if (count == paritySize)
+      {
+        return 0; // Too many to use
+      }
+      positions[count++] = i;
     }
+  }
+  return count;
+}
 
-    return errorLocator;
+void ReedSolomon::encode(ConstBitSpan input, BitBuffer &output)
+{
+  // Convert bits to symbols and pad to whole blocks of interleave messages
+  bitsToSymbols(input, symbolBuffer);
+  const size_t messageSize = static_cast<size_t>(interleave) * dataSize;
+  size_t blockCount = std::max<size_t>(1, (symbolBuffer.size() + messageSize - 1) / messageSize);
+  symbolBuffer.resize(blockCount * messageSize, 0);
+  encodeBlocks(blockCount);
+
+  // Convert back to bits
+  output.resize(codewordBuffer.size() * symbolSize);
+  symbolsToBits(codewordBuffer, output);
 }
 
-// New method: Chien search to find error positions
-std::vector<int> ReedSolomon::findErrorPositions(const std::vector<uint8_t>& errorLocator) {
-    std::vector<int> errorPositions;
-    int n = dataSize + paritySize;
-
-    // For each position in the codeword
-    for (int i = 0; i < n; i++) {
-        // Evaluate error locator at alpha^(-i)
-        uint8_t sum = 0;
-        for (size_t j = 0; j < errorLocator.size(); j++) {
-            sum ^= gfMul(errorLocator[j], gfPow(expTable[1], (fieldSize - 1 - i) * j));
-        }
+void ReedSolomon::encodeBatch(ConstBitSpan messages, BitSpan codewords)
+{
+  size_t blockCount = batchSize(messages.size(), codewords.size());
+  bitsToSymbols(messages, symbolBuffer);
+  encodeBlocks(blockCount);
+  symbolsToBits(codewordBuffer, codewords);
+}
 
-        // If the sum is zero, we found a root
-        if (sum == 0) {
-            errorPositions.push_back(i);
-        }
+void ReedSolomon::encodeBlocks(size_t blockCount)
+{
+  const size_t messageSize = static_cast<size_t>(interleave) * dataSize;
+  const size_t blockSize = static_cast<size_t>(interleave) * (dataSize + paritySize);
+  if (!inputMap.empty())
+  {
+    for (uint8_t &symbol : symbolBuffer)
+    {
+      symbol = inputMap[symbol];
     }
+  }
 
-    // Reverse the error positions to be in ascending order
-    std::reverse(errorPositions.begin(), errorPositions.end());
-    return errorPositions;
-}
+  // Each block is its interleaved data symbols followed by the interleaved
+  // parity, so the data is copied as is
+  codewordBuffer.resize(blockCount * blockSize);
+  for (size_t f = 0; f < blockCount; f++)
+  {
+    std::memcpy(&codewordBuffer[f * blockSize], &symbolBuffer[f * messageSize], messageSize);
+  }
+  uint8_t *parityBlocks = codewordBuffer.data() + messageSize;
 
-// New method: Forney algorithm to find error values
-std::vector<uint8_t> ReedSolomon::findErrorValues(const std::vector<uint8_t>& syndrome,
-                                               const std::vector<int>& errorPositions) {
-    // Calculate formal derivative of error locator polynomial
-    std::vector<uint8_t> errorLocator = findErrorLocator(syndrome);
-    std::vector<uint8_t> errorEvaluator(paritySize, 0);
-
-    // Calculate error evaluator polynomial
-    for (int i = 0; i < paritySize; i++) {
-        uint8_t sum = 0;
-        for (int j = 0; j <= i; j++) {
-            if (j < static_cast<int>(errorLocator.size()) &&
-                i - j < static_cast<int>(syndrome.size())) {
-                sum ^= gfMul(errorLocator[j], syndrome[i - j]);
-            }
-        }
-        errorEvaluator[i] = sum;
+  // Encode full groups of codewords side by side
+  size_t blocks = blockCount * interleave;
+  size_t b = 0;
+  for (; b + LANE_GROUP <= blocks; b += LANE_GROUP)
+  {
+    laneData.load(symbolBuffer.data(), messageSize, interleave, b, dataSize);
+    encodeParityLanes(laneData, laneParity);
+    laneParity.store(parityBlocks, blockSize, interleave, b, paritySize);
+  }
+
+  uint8_t dataColumn[256];
+  uint8_t parityColumn[256];
+  for (; b < blocks; b++)
+  {
+    readStrided(&symbolBuffer[codewordStart(b, interleave, messageSize)], interleave, dataSize, dataColumn);
+    encodeParity(dataColumn, parityColumn);
+    writeStrided(parityColumn, paritySize, interleave, parityBlocks + codewordStart(b, interleave, blockSize));
+  }
+
+  if (!outputMap.empty())
+  {
+    for (uint8_t &symbol : codewordBuffer)
+    {
+      symbol = outputMap[symbol];
     }
+  }
+}
 
-    // Calculate error values
-    std::vector<uint8_t> errorValues(errorPositions.size(), 0);
-    for (size_t i = 0; i < errorPositions.size(); i++) {
-        int xi = errorPositions[i];
-        uint8_t xi_inv = gfPow(expTable[1], fieldSize - 1 - xi);
+int ReedSolomon::decode(ConstBitSpan input, BitBuffer &output)
+{
+  return decode(input, ConstBitSpan(), output);
+}
 
-        // Calculate error evaluator at 1/xi
-        uint8_t eval = 0;
-        for (size_t j = 0; j < errorEvaluator.size(); j++) {
-            eval ^= gfMul(errorEvaluator[j], gfPow(xi_inv, j));
-        }
+int ReedSolomon::decode(ConstBitSpan input, ConstBitSpan erasures, BitBuffer &output)
+{
+  if (!erasures.empty() && erasures.size() != input.size())
+  {
+    output.clear();
+    return 0; // Erasure flags do not match the input
+  }
 
-        // Calculate formal derivative at xi
-        uint8_t deriv = 0;
-        for (size_t j = 1; j < errorLocator.size(); j++) {
-            if (j % 2 == 1) { // Only odd terms (derivative of x^2 is 0 in GF(2^m))
-                deriv ^= gfMul(errorLocator[j], gfPow(xi_inv, j - 1));
-            }
-        }
+  // Convert bits to symbols; a symbol with any flagged bit is erased
+  bitsToSymbols(input, symbolBuffer);
+  if (erasures.empty())
+  {
+    erasureBuffer.clear();
+  }
+  else
+  {
+    bitsToSymbols(erasures, erasureBuffer);
+  }
 
-        if (deriv == 0) {
-            // Cannot correct error at this position
-            continue;
-        }
+  // Ensure we have whole blocks of codewords
+  const size_t blockSize = static_cast<size_t>(interleave) * (dataSize + paritySize);
+  if (symbolBuffer.empty() || symbolBuffer.size() % blockSize != 0 || input.size() % symbolSize != 0)
+  {
+    output.clear();
+    return 0; // Invalid input size
+  }
 
-        // Calculate error value
-        errorValues[i] = gfDiv(eval, deriv);
-    }
+  size_t blockCount = symbolBuffer.size() / blockSize;
+  int errorsFixed = decodeBlocks(blockCount, nullptr);
+
+  // Convert back to bits
+  output.resize(codewordBuffer.size() * symbolSize);
+  symbolsToBits(codewordBuffer, output);
 
-    return errorValues;
+  return errorsFixed;
 }
 
-std::pair<std::vector<uint8_t>, int> ReedSolomon::decodeSymbols(const std::vector<uint8_t>& receivedSymbols) {
-    // Compute syndrome values
-    std::vector<uint8_t> syndrome = computeSyndrome(receivedSymbols);
+int ReedSolomon::decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                             CodewordStatus *status)
+{
+  size_t blockCount = batchSize(messages.size(), codewords.size());
+  if (!erasures.empty() && erasures.size() != codewords.size())
+  {
+    throw std::invalid_argument("Erasure flags must match the received bits");
+  }
 
-    // Check if syndrome is all zeros (no errors)
-    bool hasErrors = false;
-    for (size_t i = 0; i < syndrome.size(); i++) {
-        if (syndrome[i] != 0) {
-            hasErrors = true;
-            break;
-        }
+  bitsToSymbols(codewords, symbolBuffer);
+  if (erasures.empty())
+  {
+    erasureBuffer.clear();
+  }
+  else
+  {
+    bitsToSymbols(erasures, erasureBuffer);
+  }
+
+  int errorsFixed = decodeBlocks(blockCount, status);
+  symbolsToBits(codewordBuffer, messages);
+  return errorsFixed;
+}
+
+int ReedSolomon::decodeBlocks(size_t blockCount, CodewordStatus *status)
+{
+  const size_t n = dataSize + paritySize;
+  const size_t messageSize = static_cast<size_t>(interleave) * dataSize;
+  const size_t blockSize = static_cast<size_t>(interleave) * n;
+
+  if (!inputMap.empty())
+  {
+    for (uint8_t &symbol : symbolBuffer)
+    {
+      symbol = inputMap[symbol];
     }
+  }
+  if (status)
+  {
+    std::fill(status, status + blockCount, CodewordStatus());
+  }
 
-    std::vector<uint8_t> correctedSymbols = receivedSymbols;
-    int errorsFixed = 0;
-
-    if (hasErrors) {
-        try {
-            // Find error positions using Berlekamp-Massey and Chien search
-            std::vector<uint8_t> errorLocator = findErrorLocator(syndrome);
-            std::vector<int> errorPositions = findErrorPositions(errorLocator);
-
-            // Find error values using Forney algorithm
-            std::vector<uint8_t> errorValues = findErrorValues(syndrome, errorPositions);
-
-            // Correct errors
-            for (size_t i = 0; i < errorPositions.size(); i++) {
-                int pos = errorPositions[i];
-                if (pos < static_cast<int>(correctedSymbols.size())) {
-                    correctedSymbols[pos] ^= errorValues[i];
-                    errorsFixed++;
-                }
-            }
-
-            // Verify correction by recomputing syndrome
-            std::vector<uint8_t> checkSyndrome = computeSyndrome(correctedSymbols);
-            bool allZero = true;
-            for (size_t i = 0; i < checkSyndrome.size(); i++) {
-                if (checkSyndrome[i] != 0) {
-                    allZero = false;
-                    break;
-                }
-            }
-
-            // If syndrome is not all zeros, error correction failed
-            if (!allZero) {
-                errorsFixed = 0;  // Indicate failure
-            }
-        } catch (const std::exception& e) {
-            // Error correction failed
-            errorsFixed = 0;
-        }
+  size_t blocks = blockCount * interleave;
+  uint8_t codeword[256];
+  int erased[256];
+  int errorsFixed = 0;
+  syndromeBuffer.resize(paritySize);
+
+  // Check full groups of codewords side by side; only groups with a
+  // nonzero remainder go through error correction
+  size_t b = 0;
+  for (; b + LANE_GROUP <= blocks; b += LANE_GROUP)
+  {
+    laneReceived.load(symbolBuffer.data(), blockSize, interleave, b, n);
+    encodeParityLanes(laneReceived, laneParity);
+
+    uint8_t any = 0;
+    for (int j = 0; j < paritySize; j++)
+    {
+      uint8_t *remainder = laneParity.row(j);
+      const uint8_t *received = laneReceived.row(dataSize + j);
+      for (size_t l = 0; l < LANE_GROUP; l++)
+      {
+        remainder[l] ^= received[l];
+        any |= remainder[l];
+      }
+    }
+    if (any != 0)
+    {
+      syndromesLanes(laneParity, laneSyndromes);
+      errorsFixed += correctLanes(b, status);
+    }
+  }
+
+  // Remaining codewords one at a time
+  for (; b < blocks; b++)
+  {
+    uint8_t *symbols = &symbolBuffer[codewordStart(b, interleave, blockSize)];
+    readStrided(symbols, interleave, static_cast<int>(n), codeword);
+    if (computeSyndromes(codeword, syndromeBuffer.data()))
+    {
+      int erasureCount = findErasures(b, erased);
+      int fixed = corrector.correct(codeword, syndromeBuffer.data(), erased, erasureCount);
+      if (fixed > 0)
+      {
+        writeStrided(codeword, dataSize, interleave, symbols);
+        errorsFixed += fixed;
+      }
+      recordOutcome(b, fixed, status);
     }
+  }
+
+  // Keep the interleaved data symbols of each block
+  codewordBuffer.resize(blockCount * messageSize);
+  for (size_t f = 0; f < blockCount; f++)
+  {
+    std::memcpy(&codewordBuffer[f * messageSize], &symbolBuffer[f * blockSize], messageSize);
+  }
 
-    // Extract data symbols (first dataSize symbols)
-    std::vector<uint8_t> dataSymbols(dataSize);
-    for (int i = 0; i < dataSize; i++) {
-        dataSymbols[i] = correctedSymbols[i];
+  if (!outputMap.empty())
+  {
+    for (uint8_t &symbol : codewordBuffer)
+    {
+      symbol = outputMap[symbol];
     }
+  }
 
-    return {dataSymbols, errorsFixed};
+  return errorsFixed;
 }
 
-std::vector<bool> ReedSolomon::encode(const std::vector<bool>& input) {
-    // Convert bits to symbols
-    std::vector<uint8_t> symbols = bitsToSymbols(input);
-
-    // Pad or truncate to match dataSize
-    if (symbols.size() < static_cast<size_t>(dataSize)) {
-        symbols.resize(dataSize, 0); // Pad with zeros
-    } else if (symbols.size() > static_cast<size_t>(dataSize)) {
-        symbols.resize(dataSize);    // Truncate
+int ReedSolomon::correctLanes(size_t first, CodewordStatus *status)
+{
+  const int n = dataSize + paritySize;
+  const size_t blockSize = static_cast<size_t>(interleave) * n;
+  uint8_t codeword[256];
+  uint8_t lambda[256];
+  int erased[256];
+  int errorsFixed = 0;
+
+  size_t dirty[LANE_GROUP];
+  size_t dirtyCount = 0;
+  for (size_t l = 0; l < LANE_GROUP; l++)
+  {
+    uint8_t any = 0;
+    for (int i = 0; i < paritySize; i++)
+    {
+      any |= laneSyndromes.at(l, i);
     }
+    if (any != 0)
+    {
+      dirty[dirtyCount++] = l;
+    }
+  }
 
-    // Encode symbols
-    std::vector<uint8_t> encodedSymbols = encodeSymbols(symbols);
+  bool searchLanes = false;
+#ifdef RS_HAVE_AVX2_KERNELS
+  searchLanes = dirtyCount >= CHIEN_LANE_MIN && CpuFeatures::hasAvx2();
+  if (searchLanes)
+  {
+    // Clean lanes, and those with too many errors, keep Lambda = 1, which has no roots
+    std::fill(laneLocators.row(0), laneLocators.row(1), 1);
+    std::fill(laneLocators.row(1), laneLocators.row(paritySize + 1), 0);
+    int maxDegree = 0;
+    for (size_t d = 0; d < dirtyCount; d++)
+    {
+      size_t l = dirty[d];
+      for (int i = 0; i < paritySize; i++)
+      {
+        syndromeBuffer[i] = laneSyndromes.at(l, i);
+      }
+      int erasureCount = findErasures(first + l, erased);
+      laneDegrees[l] = corrector.locate(syndromeBuffer.data(), erased, erasureCount, lambda);
+      for (int k = 0; k <= laneDegrees[l]; k++)
+      {
+        laneLocators.at(l, k) = lambda[k];
+      }
+      maxDegree = std::max(maxDegree, laneDegrees[l]);
+    }
 
-    // Convert back to bits
-    return symbolsToBits(encodedSymbols);
-}
+    chienLanesAvx2(laneLocators.row(0), laneLocators.stride(), maxDegree, n, chienStartTables.data(),
+                   chienStepTables.data(), rootMasks.data());
 
-std::pair<std::vector<bool>, int> ReedSolomon::decode(const std::vector<bool>& input) {
-    // Convert bits to symbols
-    std::vector<uint8_t> receivedSymbols = bitsToSymbols(input);
+    // Roots past paritySize are only counted; the count then exceeds the degree
+    std::fill(laneRootCounts.begin(), laneRootCounts.end(), 0);
+    for (int j = 0; j < n; j++)
+    {
+      for (uint32_t lanes = rootMasks[j]; lanes != 0; lanes &= lanes - 1)
+      {
+        int l = __builtin_ctz(lanes);
+        if (laneRootCounts[l] < paritySize)
+        {
+          laneRoots[l * paritySize + laneRootCounts[l]] = j;
+        }
+        laneRootCounts[l]++;
+      }
+    }
+  }
+#endif
 
-    // Ensure we have the right number of symbols
-    if (receivedSymbols.size() != static_cast<size_t>(dataSize + paritySize)) {
-        return {{}, 0}; // Invalid input size
+  for (size_t d = 0; d < dirtyCount; d++)
+  {
+    size_t l = dirty[d];
+    for (int i = 0; i < paritySize; i++)
+    {
+      syndromeBuffer[i] = laneSyndromes.at(l, i);
+    }
+    for (int i = 0; i < n; i++)
+    {
+      codeword[i] = laneReceived.at(l, i);
     }
+    int erasureCount = findErasures(first + l, erased);
 
-    // Decode symbols
-    auto [decodedSymbols, errorsFixed] = decodeSymbols(receivedSymbols);
+    int fixed;
+    if (searchLanes)
+    {
+      for (int k = 0; k <= paritySize; k++)
+      {
+        lambda[k] = laneLocators.at(l, k);
+      }
+      fixed = corrector.correct(codeword, syndromeBuffer.data(), erased, erasureCount, lambda, laneDegrees[l],
+                                &laneRoots[l * paritySize], laneRootCounts[l]);
+    }
+    else
+    {
+      fixed = corrector.correct(codeword, syndromeBuffer.data(), erased, erasureCount);
+    }
 
-    // Convert back to bits
-    std::vector<bool> decodedBits = symbolsToBits(decodedSymbols);
+    if (fixed > 0)
+    {
+      writeStrided(codeword, dataSize, interleave, &symbolBuffer[codewordStart(first + l, interleave, blockSize)]);
+      errorsFixed += fixed;
+    }
+    recordOutcome(first + l, fixed, status);
+  }
+  return errorsFixed;
+}
 
-    return {decodedBits, errorsFixed};
+void ReedSolomon::recordOutcome(size_t codeword, int fixed, CodewordStatus *status) const
+{
+  // The syndromes were nonzero, so no correction means the decoder gave up
+  if (status)
+  {
+    CodewordStatus &block = status[codeword / interleave];
+    block.corrected += fixed;
+    block.failed = block.failed || fixed == 0;
+  }
 }
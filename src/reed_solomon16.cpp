@@ -0,0 +1,388 @@
+#include "../include/reed_solomon16.h"
+#include "../include/cpu_features.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RS16_HAVE_AVX2_KERNELS 1
+#endif
+
+namespace
+{
+  /*
+   * Table-driven LFSR on a register packed four symbols per word. The
+   * feedback product v * g is split into the products of its low and high
+   * bytes, so each data symbol costs two row lookups, a one-symbol shift of
+   * the register and two XORs per word.
+   */
+  template <int Words>
+  void lfsrWords(const uint16_t *data, int dataSize, const uint64_t *lowRows, const uint64_t *highRows,
+                 int rowWords, uint64_t *reg)
+  {
+    const int words = Words > 0 ? Words : rowWords;
+    for (int w = 0; w < words; w++)
+    {
+      reg[w] = 0;
+    }
+
+    for (int i = 0; i < dataSize; i++)
+    {
+      unsigned feedback = data[i] ^ static_cast<unsigned>(reg[0] & 0xFFFF);
+      const uint64_t *low = lowRows + static_cast<size_t>(feedback & 0xFF) * words;
+      const uint64_t *high = highRows + static_cast<size_t>(feedback >> 8) * words;
+      for (int w = 0; w + 1 < words; w++)
+      {
+        reg[w] = ((reg[w] >> 16) | (reg[w + 1] << 48)) ^ low[w] ^ high[w];
+      }
+      reg[words - 1] = (reg[words - 1] >> 16) ^ low[words - 1] ^ high[words - 1];
+    }
+  }
+
+#ifdef RS16_HAVE_AVX2_KERNELS
+  /*
+   * The same LFSR sixteen symbols per vector. The one-symbol shift across
+   * vectors pairs the high half of each vector with the low half of the
+   * next one and aligns the pair two bytes down.
+   */
+  template <int Vectors>
+  __attribute__((target("avx2"))) void lfsrAvx2(const uint16_t *data, int dataSize, const uint64_t *lowRows,
+                                                const uint64_t *highRows, int rowWords, uint64_t *state)
+  {
+    const int vectors = Vectors > 0 ? Vectors : rowWords / 4;
+    __m256i *reg = reinterpret_cast<__m256i *>(state);
+    __m256i fixed[Vectors > 0 ? Vectors : 1];
+    if (Vectors > 0)
+    {
+      reg = fixed;
+    }
+    for (int v = 0; v < vectors; v++)
+    {
+      _mm256_storeu_si256(reg + v, _mm256_setzero_si256());
+    }
+
+    for (int i = 0; i < dataSize; i++)
+    {
+      unsigned feedback = data[i] ^ static_cast<unsigned>(_mm256_extract_epi16(_mm256_loadu_si256(reg), 0));
+      const __m256i *low = reinterpret_cast<const __m256i *>(lowRows + static_cast<size_t>(feedback & 0xFF) * rowWords);
+      const __m256i *high = reinterpret_cast<const __m256i *>(highRows + static_cast<size_t>(feedback >> 8) * rowWords);
+
+      __m256i current = _mm256_loadu_si256(reg);
+      for (int v = 0; v < vectors; v++)
+      {
+        __m256i next = v + 1 < vectors ? _mm256_loadu_si256(reg + v + 1) : _mm256_setzero_si256();
+        __m256i shifted = _mm256_alignr_epi8(_mm256_permute2x128_si256(current, next, 0x21), current, 2);
+        shifted = _mm256_xor_si256(shifted, _mm256_xor_si256(_mm256_loadu_si256(low + v), _mm256_loadu_si256(high + v)));
+        _mm256_storeu_si256(reg + v, shifted);
+        current = next;
+      }
+    }
+
+    if (Vectors > 0)
+    {
+      std::memcpy(state, fixed, sizeof(fixed));
+    }
+  }
+#endif
+}
+
+ReedSolomon16::ReedSolomon16(int dataSize, int paritySize)
+    : dataSize(dataSize), paritySize(paritySize)
+{
+  field = &GaloisField::get(16, GaloisField::defaultPolynomial(16));
+
+  if (dataSize < 1 || paritySize < 1 || dataSize + paritySize > field->order)
+  {
+    throw std::invalid_argument("Codeword length must be at most 65535 symbols");
+  }
+
+  initEncoder();
+  corrector = RsCorrector<uint16_t>(*field, dataSize, paritySize, 0, 1);
+}
+
+void ReedSolomon16::initEncoder()
+{
+  // g(x) = (x - a^0)(x - a^1)...(x - a^(paritySize-1)), highest degree first
+  generator.assign(1, 1);
+  for (int i = 0; i < paritySize; i++)
+  {
+    generator.push_back(0);
+    for (size_t j = generator.size() - 1; j > 0; j--)
+    {
+      generator[j] ^= field->mul(generator[j - 1], field->exp[i]);
+    }
+  }
+
+  // Rows are padded to whole 16-symbol vectors for the AVX2 kernel
+  rowWords = 4 * ((paritySize + 15) / 16);
+  lowRows.assign(256 * static_cast<size_t>(rowWords), 0);
+  highRows.assign(256 * static_cast<size_t>(rowWords), 0);
+  for (int v = 0; v < 256; v++)
+  {
+    for (int j = 0; j < paritySize; j++)
+    {
+      uint64_t low = field->mul(static_cast<uint16_t>(v), generator[j + 1]);
+      uint64_t high = field->mul(static_cast<uint16_t>(v << 8), generator[j + 1]);
+      lowRows[v * rowWords + j / 4] |= low << (16 * (j % 4));
+      highRows[v * rowWords + j / 4] |= high << (16 * (j % 4));
+    }
+  }
+
+  registerBuffer.resize(rowWords);
+  remainderBuffer.resize(paritySize);
+  syndromeBuffer.resize(paritySize);
+  erasurePositions.reserve(dataSize + paritySize);
+}
+
+void ReedSolomon16::encodeParity(const uint16_t *data, uint16_t *parity)
+{
+  // Divide data(x) * x^paritySize by g(x); the register holds the remainder
+  uint64_t *reg = registerBuffer.data();
+
+#ifdef RS16_HAVE_AVX2_KERNELS
+  if (CpuFeatures::hasAvx2())
+  {
+    switch (rowWords)
+    {
+    case 4:
+      lfsrAvx2<1>(data, dataSize, lowRows.data(), highRows.data(), rowWords, reg);
+      break;
+    case 8:
+      lfsrAvx2<2>(data, dataSize, lowRows.data(), highRows.data(), rowWords, reg);
+      break;
+    case 16:
+      lfsrAvx2<4>(data, dataSize, lowRows.data(), highRows.data(), rowWords, reg);
+      break;
+    default:
+      lfsrAvx2<0>(data, dataSize, lowRows.data(), highRows.data(), rowWords, reg);
+      break;
+    }
+  }
+  else
+#endif
+  {
+    switch (rowWords)
+    {
+    case 4:
+      lfsrWords<4>(data, dataSize, lowRows.data(), highRows.data(), rowWords, reg);
+      break;
+    case 16:
+      lfsrWords<16>(data, dataSize, lowRows.data(), highRows.data(), rowWords, reg);
+      break;
+    default:
+      lfsrWords<0>(data, dataSize, lowRows.data(), highRows.data(), rowWords, reg);
+      break;
+    }
+  }
+
+  for (int j = 0; j < paritySize; j++)
+  {
+    parity[j] = static_cast<uint16_t>(reg[j / 4] >> (16 * (j % 4)));
+  }
+}
+
+void ReedSolomon16::bitsToSymbols(ConstBitSpan bits, std::vector<uint16_t> &symbols) const
+{
+  // Pad the last symbol with zeros if bits is not a multiple of 16
+  size_t count = (bits.size() + 15) / 16;
+  symbols.resize(count);
+
+  // Convert four symbols at a time
+  size_t i = 0;
+  for (; (i + 4) * 16 <= bits.size(); i += 4)
+  {
+    uint64_t word = bits.getBits(i * 16, 64);
+    for (size_t j = 0; j < 4; j++)
+    {
+      symbols[i + j] = static_cast<uint16_t>(word >> (16 * j));
+    }
+  }
+
+  // Convert the remaining symbols one at a time
+  for (; i < count; i++)
+  {
+    size_t pos = i * 16;
+    int available = static_cast<int>(std::min<size_t>(16, bits.size() - pos));
+    symbols[i] = static_cast<uint16_t>(bits.getBits(pos, available));
+  }
+}
+
+void ReedSolomon16::symbolsToBits(const std::vector<uint16_t> &symbols, BitSpan bits) const
+{
+  // Convert four symbols at a time
+  size_t i = 0;
+  for (; i + 4 <= symbols.size(); i += 4)
+  {
+    uint64_t word = 0;
+    for (size_t j = 0; j < 4; j++)
+    {
+      word |= static_cast<uint64_t>(symbols[i + j]) << (16 * j);
+    }
+    bits.setBits(i * 16, 64, word);
+  }
+
+  // Convert the remaining symbols one at a time
+  for (; i < symbols.size(); i++)
+  {
+    bits.setBits(i * 16, 16, symbols[i]);
+  }
+}
+
+void ReedSolomon16::encode(ConstBitSpan input, BitBuffer &output)
+{
+  // Convert bits to symbols and pad to whole messages
+  bitsToSymbols(input, symbolBuffer);
+  size_t blocks = std::max<size_t>(1, (symbolBuffer.size() + dataSize - 1) / dataSize);
+  symbolBuffer.resize(blocks * dataSize, 0);
+  encodeBlocks(blocks);
+
+  // Convert back to bits
+  output.resize(codewordBuffer.size() * 16);
+  symbolsToBits(codewordBuffer, output);
+}
+
+void ReedSolomon16::encodeBatch(ConstBitSpan messages, BitSpan codewords)
+{
+  size_t blocks = batchSize(messages.size(), codewords.size());
+  bitsToSymbols(messages, symbolBuffer);
+  encodeBlocks(blocks);
+  symbolsToBits(codewordBuffer, codewords);
+}
+
+void ReedSolomon16::encodeBlocks(size_t blocks)
+{
+  // Each codeword is its data symbols followed by the parity
+  size_t n = dataSize + paritySize;
+  codewordBuffer.resize(blocks * n);
+  for (size_t b = 0; b < blocks; b++)
+  {
+    const uint16_t *data = &symbolBuffer[b * dataSize];
+    std::copy(data, data + dataSize, &codewordBuffer[b * n]);
+    encodeParity(data, &codewordBuffer[b * n + dataSize]);
+  }
+}
+
+int ReedSolomon16::decode(ConstBitSpan input, BitBuffer &output)
+{
+  return decode(input, ConstBitSpan(), output);
+}
+
+int ReedSolomon16::decode(ConstBitSpan input, ConstBitSpan erasures, BitBuffer &output)
+{
+  // Ensure we have whole codewords and matching erasure flags
+  size_t n = dataSize + paritySize;
+  if (input.empty() || input.size() % (n * 16) != 0 || (!erasures.empty() && erasures.size() != input.size()))
+  {
+    output.clear();
+    return 0; // Invalid input size
+  }
+
+  // Convert bits to symbols; a symbol with any flagged bit is erased
+  bitsToSymbols(input, symbolBuffer);
+  if (erasures.empty())
+  {
+    erasureBuffer.clear();
+  }
+  else
+  {
+    bitsToSymbols(erasures, erasureBuffer);
+  }
+
+  int errorsFixed = decodeBlocks(symbolBuffer.size() / n, nullptr);
+
+  // Convert back to bits
+  output.resize(codewordBuffer.size() * 16);
+  symbolsToBits(codewordBuffer, output);
+
+  return errorsFixed;
+}
+
+int ReedSolomon16::decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                               CodewordStatus *status)
+{
+  size_t blocks = batchSize(messages.size(), codewords.size());
+  if (!erasures.empty() && erasures.size() != codewords.size())
+  {
+    throw std::invalid_argument("Erasure flags must match the received bits");
+  }
+
+  bitsToSymbols(codewords, symbolBuffer);
+  if (erasures.empty())
+  {
+    erasureBuffer.clear();
+  }
+  else
+  {
+    bitsToSymbols(erasures, erasureBuffer);
+  }
+
+  int errorsFixed = decodeBlocks(blocks, status);
+  symbolsToBits(codewordBuffer, messages);
+  return errorsFixed;
+}
+
+int ReedSolomon16::decodeBlocks(size_t blocks, CodewordStatus *status)
+{
+  size_t n = dataSize + paritySize;
+  int errorsFixed = 0;
+
+  for (size_t b = 0; b < blocks; b++)
+  {
+    uint16_t *received = &symbolBuffer[b * n];
+
+    // r(x) mod g(x) is the parity of the received data XOR the received parity
+    encodeParity(received, remainderBuffer.data());
+    uint16_t any = 0;
+    for (int j = 0; j < paritySize; j++)
+    {
+      remainderBuffer[j] ^= received[dataSize + j];
+      any |= remainderBuffer[j];
+    }
+    if (any == 0)
+    {
+      if (status)
+      {
+        status[b] = CodewordStatus();
+      }
+      continue;
+    }
+
+    erasurePositions.clear();
+    if (!erasureBuffer.empty())
+    {
+      for (size_t i = 0; i < n; i++)
+      {
+        if (erasureBuffer[b * n + i] != 0)
+        {
+          erasurePositions.push_back(static_cast<int>(i));
+        }
+      }
+      // Too many to use
+      if (erasurePositions.size() > static_cast<size_t>(paritySize))
+      {
+        erasurePositions.clear();
+      }
+    }
+
+    corrector.syndromesFromRemainder(remainderBuffer.data(), syndromeBuffer.data());
+    int fixed = corrector.correct(received, syndromeBuffer.data(), erasurePositions.data(),
+                                  static_cast<int>(erasurePositions.size()));
+    errorsFixed += fixed;
+
+    // The remainder was nonzero, so no correction means the decoder gave up
+    if (status)
+    {
+      status[b] = {fixed, fixed == 0};
+    }
+  }
+
+  // Keep the data symbols of each codeword
+  codewordBuffer.resize(blocks * dataSize);
+  for (size_t b = 0; b < blocks; b++)
+  {
+    std::copy(&symbolBuffer[b * n], &symbolBuffer[b * n] + dataSize, &codewordBuffer[b * dataSize]);
+  }
+
+  return errorsFixed;
+}
@@ -0,0 +1,303 @@
+#include "../include/rs_corrector.h"
+#include <algorithm>
+
+template <typename Symbol>
+RsCorrector<Symbol>::RsCorrector(const GaloisField &field, int dataSize, int paritySize, int firstRoot, int rootStep)
+    : field(&field), dataSize(dataSize), paritySize(paritySize), firstRoot(firstRoot), rootStep(rootStep),
+      locator(paritySize + 1), previous(paritySize + 1), saved(paritySize + 1), evaluator(paritySize),
+      values(paritySize + 1), positions(paritySize + 1), termLog(paritySize + 1), termStep(paritySize + 1)
+{
+}
+
+template <typename Symbol>
+void RsCorrector<Symbol>::syndromesFromRemainder(const Symbol *remainder, Symbol *syndromes)
+{
+  // g vanishes at every syndrome root, so r(x) and the remainder agree there.
+  // Each nonzero term R_k * x^d, d = paritySize-1-k, is kept in log form and
+  // advanced by d * log(beta) from one syndrome to the next, so the terms are
+  // independent instead of one serial Horner chain per syndrome.
+  const int order = field->order;
+  const uint16_t *expTable = field->exp;
+  const uint32_t *logTable = field->log;
+  const int64_t firstLog = static_cast<int64_t>(rootStep) * firstRoot % order;
+
+  int terms = 0;
+  for (int k = 0; k < paritySize; k++)
+  {
+    if (remainder[k] != 0)
+    {
+      int degree = paritySize - 1 - k;
+      termLog[terms] = static_cast<int>((logTable[remainder[k]] + firstLog * degree) % order);
+      termStep[terms] = static_cast<int>(static_cast<int64_t>(rootStep) * degree % order);
+      terms++;
+    }
+  }
+
+  for (int i = 0; i < paritySize; i++)
+  {
+    Symbol sum = 0;
+    for (int c = 0; c < terms; c++)
+    {
+      sum ^= expTable[termLog[c]];
+      termLog[c] += termStep[c];
+      if (termLog[c] >= order)
+      {
+        termLog[c] -= order;
+      }
+    }
+    syndromes[i] = sum;
+  }
+}
+
+template <typename Symbol>
+int RsCorrector<Symbol>::findErrorLocator(const Symbol *syndromes, const int *erasures, int erasureCount)
+{
+  // Berlekamp-Massey: shortest LFSR Lambda(x) generating S_0 .. S_(paritySize-1).
+  // Polynomials are stored lowest degree first.
+  const int n = dataSize + paritySize;
+  std::fill(locator.begin(), locator.end(), 0);
+  locator[0] = 1;
+
+  // Start from the erasure locator Gamma(x) = prod (1 + X_j x), X_j = beta^e_j
+  for (int j = 0; j < erasureCount; j++)
+  {
+    Symbol x = field->exp[static_cast<int64_t>(rootStep) * (n - 1 - erasures[j]) % field->order];
+    for (int i = j + 1; i >= 1; i--)
+    {
+      locator[i] ^= field->mul(locator[i - 1], x);
+    }
+  }
+
+  // Locator before the last length change
+  std::copy(locator.begin(), locator.end(), previous.begin());
+
+  int length = erasureCount;   // Current LFSR length L
+  int shift = 1;               // Steps since the last length change
+  Symbol previousDelta = 1;    // Discrepancy at the last length change
+
+  // The first erasureCount syndromes are accounted for by Gamma
+  for (int r = erasureCount; r < paritySize; r++)
+  {
+    // Discrepancy between S_r and the LFSR prediction
+    Symbol delta = syndromes[r];
+    for (int i = 1; i <= std::min(length, r); i++)
+    {
+      delta ^= field->mul(locator[i], syndromes[r - i]);
+    }
+
+    if (delta == 0)
+    {
+      shift++;
+      continue;
+    }
+
+    // Lambda(x) -= delta / previousDelta * x^shift * previous(x)
+    Symbol scale = field->div(delta, previousDelta);
+    if (2 * length <= r + erasureCount)
+    {
+      std::copy(locator.begin(), locator.end(), saved.begin());
+      for (int i = 0; i + shift <= paritySize; i++)
+      {
+        locator[i + shift] ^= field->mul(scale, previous[i]);
+      }
+      std::swap(previous, saved);
+      length = r + 1 + erasureCount - length;
+      previousDelta = delta;
+      shift = 1;
+    }
+    else
+    {
+      for (int i = 0; i + shift <= paritySize; i++)
+      {
+        locator[i + shift] ^= field->mul(scale, previous[i]);
+      }
+      shift++;
+    }
+  }
+
+  // More errors than the code can correct: each unknown error costs two
+  // syndromes, each erasure one
+  if (2 * length - erasureCount > paritySize)
+  {
+    return -1;
+  }
+  return length;
+}
+
+template <typename Symbol>
+int RsCorrector<Symbol>::findErrorPositions(int degree)
+{
+  // Chien search over the codeword, highest degree (index 0) first. The
+  // term Lambda_k * x^k is kept in log form; moving from beta^-e to
+  // beta^-(e-1) multiplies it by beta^k, so each position costs one add
+  // and one table lookup per term.
+  const int order = field->order;
+  const int n = dataSize + paritySize;
+  const uint16_t *expTable = field->exp;
+  const uint32_t *logTable = field->log;
+
+  for (int k = 1; k <= degree; k++)
+  {
+    // Start at x = beta^-(n-1), the position of codeword symbol 0
+    termStep[k] = static_cast<int>(static_cast<int64_t>(rootStep) * k % order);
+    termLog[k] = locator[k] == 0 ? -1
+                                 : static_cast<int>((logTable[locator[k]] + order -
+                                                     static_cast<int64_t>(termStep[k]) * (n - 1) % order) % order);
+  }
+
+  int found = 0;
+  for (int j = 0; j < n && found < degree; j++)
+  {
+    Symbol sum = locator[0];
+    for (int k = 1; k <= degree; k++)
+    {
+      if (termLog[k] >= 0)
+      {
+        sum ^= expTable[termLog[k]];
+        termLog[k] += termStep[k];
+        if (termLog[k] >= order)
+        {
+          termLog[k] -= order;
+        }
+      }
+    }
+
+    if (sum == 0)
+    {
+      positions[found++] = j;
+    }
+  }
+
+  return found;
+}
+
+template <typename Symbol>
+bool RsCorrector<Symbol>::findErrorValues(const Symbol *syndromes, int degree)
+{
+  const int order = field->order;
+  const int n = dataSize + paritySize;
+  const uint16_t *expTable = field->exp;
+  const uint32_t *logTable = field->log;
+
+  // Error evaluator Omega(x) = S(x) * Lambda(x) mod x^paritySize
+  for (int i = 0; i < paritySize; i++)
+  {
+    Symbol sum = 0;
+    for (int k = 0; k <= std::min(i, degree); k++)
+    {
+      sum ^= field->mul(locator[k], syndromes[i - k]);
+    }
+    evaluator[i] = sum;
+  }
+
+  // Forney: Y = X^(1 - firstRoot) * Omega(X^-1) / Lambda'(X^-1), with
+  // X = beta^e for the error at degree e
+  const int64_t scaleLog = ((1 - firstRoot) % order + order) % order;
+  for (int l = 0; l < degree; l++)
+  {
+    int e = n - 1 - positions[l];
+    int xLog = static_cast<int>(static_cast<int64_t>(rootStep) * e % order);
+    int inverseLog = (order - xLog) % order; // log of X^-1
+
+    Symbol omega = 0;
+    for (int i = paritySize - 1; i >= 0; i--)
+    {
+      omega = expTable[logTable[omega] + inverseLog] ^ evaluator[i];
+    }
+
+    // The formal derivative keeps the odd terms: Lambda'(x) = sum Lambda_k x^(k-1), k odd
+    Symbol derivative = 0;
+    for (int k = degree - (degree % 2 == 0 ? 1 : 0); k >= 1; k -= 2)
+    {
+      derivative = expTable[logTable[derivative] + 2 * inverseLog % order] ^ locator[k];
+    }
+
+    if (derivative == 0)
+    {
+      return false;
+    }
+
+    // An erased symbol may have been received correctly
+    if (omega == 0)
+    {
+      values[l] = 0;
+      continue;
+    }
+
+    values[l] = expTable[(logTable[omega] + scaleLog * xLog % order + order - logTable[derivative]) % order];
+  }
+
+  return true;
+}
+
+template <typename Symbol>
+int RsCorrector<Symbol>::correct(Symbol *codeword, const Symbol *syndromes, const int *erasures, int erasureCount)
+{
+  // Locate the errors once and reuse the locator for their values
+  int degree = findErrorLocator(syndromes, erasures, erasureCount);
+  if (degree <= 0)
+  {
+    return 0;
+  }
+
+  // Every root must lie inside the codeword, or there were too many errors
+  if (findErrorPositions(degree) != degree)
+  {
+    return 0;
+  }
+
+  return applyCorrections(codeword, syndromes, erasures, erasureCount, degree);
+}
+
+template <typename Symbol>
+int RsCorrector<Symbol>::locate(const Symbol *syndromes, const int *erasures, int erasureCount, Symbol *lambda)
+{
+  int degree = findErrorLocator(syndromes, erasures, erasureCount);
+  std::copy(locator.begin(), locator.end(), lambda);
+  return degree;
+}
+
+template <typename Symbol>
+int RsCorrector<Symbol>::correct(Symbol *codeword, const Symbol *syndromes, const int *erasures, int erasureCount,
+                                 const Symbol *lambda, int degree, const int *roots, int rootCount)
+{
+  if (degree <= 0 || rootCount != degree)
+  {
+    return 0;
+  }
+
+  std::copy(lambda, lambda + paritySize + 1, locator.begin());
+  std::copy(roots, roots + rootCount, positions.begin());
+  return applyCorrections(codeword, syndromes, erasures, erasureCount, degree);
+}
+
+template <typename Symbol>
+int RsCorrector<Symbol>::applyCorrections(Symbol *codeword, const Symbol *syndromes, const int *erasures,
+                                          int erasureCount, int degree)
+{
+  if (!findErrorValues(syndromes, degree))
+  {
+    return 0;
+  }
+
+  // Only an erasure can have a zero magnitude; at any other root the
+  // locator is inconsistent with the syndromes
+  for (int l = 0; l < degree; l++)
+  {
+    if (values[l] == 0 && std::find(erasures, erasures + erasureCount, positions[l]) == erasures + erasureCount)
+    {
+      return 0;
+    }
+  }
+
+  int corrected = 0;
+  for (int l = 0; l < degree; l++)
+  {
+    codeword[positions[l]] ^= values[l];
+    corrected += values[l] != 0 ? 1 : 0;
+  }
+  return corrected;
+}
+
+template class RsCorrector<uint8_t>;
+template class RsCorrector<uint16_t>;
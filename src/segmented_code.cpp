@@ -0,0 +1,161 @@
+#include "../include/segmented_code.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+
+SegmentedCode::SegmentedCode(std::unique_ptr<CodingStrategy> code, std::shared_ptr<ThreadPool> pool)
+    : code(std::move(code)), pool(std::move(pool))
+{
+  if (!this->code)
+  {
+    throw std::invalid_argument("Segmented code needs an inner code");
+  }
+}
+
+SegmentedCode::SegmentedCode(const SegmentedCode &other)
+    : CodingStrategy(other), code(other.code->clone()), pool(other.pool)
+{
+}
+
+size_t SegmentedCode::forEachTask(size_t codewords,
+                                  const std::function<void(size_t, size_t, size_t, CodingStrategy &)> &body)
+{
+  const size_t k = code->getMessageLength();
+  const size_t n = code->getCodewordLength();
+
+  // Codewords per task: a multiple of the count that ends on a word
+  // boundary of both streams, and at least about 64k encoded bits
+  size_t alignment = std::lcm(64 / std::gcd(k, size_t(64)), 64 / std::gcd(n, size_t(64)));
+  size_t perTask = std::max<size_t>(1, 65536 / n);
+  perTask = (perTask + alignment - 1) / alignment * alignment;
+  size_t tasks = (codewords + perTask - 1) / perTask;
+  taskErrors.assign(tasks, 0);
+
+  // Clone the inner code for every worker that may run a task now, so the
+  // calls after the first one allocate nothing
+  bool parallel = pool && tasks > 1;
+  workerCodes.resize(pool ? pool->size() : 1);
+  for (size_t worker = 0; worker < (parallel ? workerCodes.size() : 1); worker++)
+  {
+    if (!workerCodes[worker])
+    {
+      workerCodes[worker] = code->clone();
+    }
+  }
+
+  auto runTask = [&](size_t task, unsigned worker)
+  {
+    size_t first = task * perTask;
+    body(task, first, std::min(perTask, codewords - first), *workerCodes[worker]);
+  };
+
+  if (parallel)
+  {
+    // Passed by reference, so std::function does not copy the lambda to the heap
+    pool->parallelFor(tasks, std::cref(runTask));
+  }
+  else
+  {
+    for (size_t task = 0; task < tasks; task++)
+    {
+      runTask(task, 0);
+    }
+  }
+  return tasks;
+}
+
+void SegmentedCode::encode(ConstBitSpan input, BitBuffer &output)
+{
+  const size_t k = code->getMessageLength();
+  const size_t n = code->getCodewordLength();
+  if (input.size() > 0xFFFFFFFFu)
+  {
+    throw std::invalid_argument("Stream too long for the length header");
+  }
+
+  // Length header, data, then zeros up to whole messages
+  size_t codewords = (LENGTH_BITS + input.size() + k - 1) / k;
+  frameBuffer.reset(codewords * k);
+  frameBuffer.setBits(0, LENGTH_BITS, input.size());
+  frameBuffer.span().subspan(LENGTH_BITS, input.size()).copyFrom(input);
+
+  output.reset(codewords * n);
+  encodeBatch(frameBuffer, output);
+}
+
+void SegmentedCode::encodeBatch(ConstBitSpan messages, BitSpan codewords)
+{
+  const size_t k = code->getMessageLength();
+  const size_t n = code->getCodewordLength();
+  size_t total = batchSize(messages.size(), codewords.size());
+
+  // Task boundaries only fall on whole words of an output that starts on one
+  if (codewords.offset() != 0)
+  {
+    code->encodeBatch(messages, codewords);
+    return;
+  }
+
+  auto encodeTask = [&](size_t, size_t first, size_t count, CodingStrategy &worker)
+  {
+    worker.encodeBatch(messages.subspan(first * k, count * k), codewords.subspan(first * n, count * n));
+  };
+  forEachTask(total, std::cref(encodeTask));
+}
+
+int SegmentedCode::decode(ConstBitSpan input, BitBuffer &output)
+{
+  return decode(input, ConstBitSpan(), output);
+}
+
+int SegmentedCode::decode(ConstBitSpan input, ConstBitSpan erasures, BitBuffer &output)
+{
+  const size_t k = code->getMessageLength();
+  const size_t n = code->getCodewordLength();
+
+  // Ensure we have whole codewords, enough for the header, and matching erasure flags
+  if (input.size() % n != 0 || input.size() / n * k < static_cast<size_t>(LENGTH_BITS) ||
+      (!erasures.empty() && erasures.size() != input.size()))
+  {
+    output.clear();
+    return 0; // Invalid input size
+  }
+
+  frameBuffer.reset(input.size() / n * k);
+  int errorsFixed = decodeBatch(input, erasures, frameBuffer, nullptr);
+
+  // A corrupted header cannot claim more bits than were received
+  size_t length = std::min<size_t>(frameBuffer.getBits(0, LENGTH_BITS), frameBuffer.size() - LENGTH_BITS);
+  output.resize(length);
+  output.span().copyFrom(frameBuffer.view().subspan(LENGTH_BITS, length));
+
+  return errorsFixed;
+}
+
+int SegmentedCode::decodeBatch(ConstBitSpan codewords, ConstBitSpan erasures, BitSpan messages,
+                               CodewordStatus *status)
+{
+  const size_t k = code->getMessageLength();
+  const size_t n = code->getCodewordLength();
+  size_t total = batchSize(messages.size(), codewords.size());
+  if (!erasures.empty() && erasures.size() != codewords.size())
+  {
+    throw std::invalid_argument("Erasure flags must match the received bits");
+  }
+
+  if (messages.offset() != 0)
+  {
+    return code->decodeBatch(codewords, erasures, messages, status);
+  }
+
+  auto decodeTask = [&](size_t task, size_t first, size_t count, CodingStrategy &worker)
+  {
+    taskErrors[task] = worker.decodeBatch(codewords.subspan(first * n, count * n),
+                                          erasures.empty() ? ConstBitSpan() : erasures.subspan(first * n, count * n),
+                                          messages.subspan(first * k, count * k),
+                                          status ? status + first : nullptr);
+  };
+  forEachTask(total, std::cref(decodeTask));
+  return std::accumulate(taskErrors.begin(), taskErrors.end(), 0);
+}
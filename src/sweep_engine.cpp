@@ -0,0 +1,229 @@
+#include "../include/sweep_engine.h"
+#include "../include/bit_buffer.h"
+#include "../include/channel.h"
+#include "../include/coding_factory.h"
+#include "../include/philox.h"
+#include "../include/thread_pool.h"
+#include "../include/utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+
+namespace
+{
+  // State owned by one worker thread for the duration of a point
+  struct WorkerState
+  {
+    std::unique_ptr<CodingStrategy> strategy;
+    std::unique_ptr<ChannelModel> channel;
+    Philox messageRng;
+
+    BitBuffer message;
+    BitBuffer encoded;
+    BitBuffer received;
+    BitBuffer decoded;
+
+    SweepPoint totals;
+  };
+
+  // Fill a buffer with uniformly random bits
+  void randomize(BitBuffer &bits, Philox &rng)
+  {
+    size_t i = 0;
+    for (; i + 64 <= bits.size(); i += 64)
+    {
+      bits.setBits(i, 64, rng.next());
+    }
+    if (i < bits.size())
+    {
+      bits.setBits(i, static_cast<int>(bits.size() - i), rng.next());
+    }
+  }
+
+  // Stream ids: bit 63 separates message and noise, then 31 bits of point and 32 bits of chunk
+  const uint64_t MESSAGE_STREAM = uint64_t(1) << 63;
+
+  uint64_t streamId(uint64_t pointIndex, uint64_t chunk)
+  {
+    return (pointIndex << 32) | chunk;
+  }
+}
+
+double SweepPoint::getBitErrorRate() const
+{
+  if (messageBits == 0)
+    return 0.0;
+  return static_cast<double>(bitErrors) / messageBits;
+}
+
+double SweepPoint::getFrameErrorRate() const
+{
+  if (frames == 0)
+    return 0.0;
+  return static_cast<double>(frameErrors) / frames;
+}
+
+double SweepPoint::getChannelErrorRate() const
+{
+  if (channelBits == 0)
+    return 0.0;
+  return static_cast<double>(channelErrors) / channelBits;
+}
+
+SweepEngine::SweepEngine(const SweepConfig &config) : config(config)
+{
+  if (this->config.strategies.empty())
+  {
+    this->config.strategies = CodingFactory::getInstance().getStrategyNames();
+  }
+}
+
+std::vector<SweepPoint> SweepEngine::run(const std::function<void(const SweepPoint &)> &onPoint)
+{
+  ThreadPool pool(config.threads);
+  std::vector<SweepPoint> results;
+
+  for (const auto &strategy : config.strategies)
+  {
+    for (double errorRate : config.errorRates)
+    {
+      results.push_back(runPoint(strategy, errorRate, results.size(), pool));
+      if (onPoint)
+      {
+        onPoint(results.back());
+      }
+    }
+  }
+
+  return results;
+}
+
+SweepPoint SweepEngine::runPoint(const std::string &strategyName, double errorRate, uint64_t pointIndex, ThreadPool &pool)
+{
+  auto startTime = std::chrono::steady_clock::now();
+
+  // Give every worker its own strategy, channel and buffers
+  std::unique_ptr<CodingStrategy> prototype = CodingFactory::getInstance().createStrategy(strategyName);
+  double codeRate = static_cast<double>(prototype->getMessageLength()) / prototype->getCodewordLength();
+  std::unique_ptr<ChannelModel> channel = config.channelFactory
+                                              ? config.channelFactory(errorRate, codeRate)
+                                              : std::make_unique<Channel>(errorRate, config.seed);
+  std::vector<WorkerState> workers(pool.size());
+  for (auto &worker : workers)
+  {
+    worker.strategy = prototype->clone();
+    worker.channel = channel->clone();
+    worker.message.resize(prototype->getMessageLength());
+  }
+
+  uint64_t chunks = (config.framesPerPoint + CHUNK_FRAMES - 1) / CHUNK_FRAMES;
+  std::atomic<uint64_t> frameErrorsSeen(0);
+
+  pool.parallelFor(chunks, [&](size_t chunk, unsigned workerId)
+                   {
+    // Skip the remaining chunks once enough frame errors have been observed
+    if (config.maxFrameErrors != 0 && frameErrorsSeen.load(std::memory_order_relaxed) >= config.maxFrameErrors)
+    {
+      return;
+    }
+
+    WorkerState &worker = workers[workerId];
+    SweepPoint &totals = worker.totals;
+    uint64_t first = chunk * CHUNK_FRAMES;
+    uint64_t count = std::min<uint64_t>(CHUNK_FRAMES, config.framesPerPoint - first);
+    size_t messageLength = worker.message.size();
+    uint64_t chunkFrameErrors = 0;
+
+    // Every chunk draws from its own streams, whichever worker runs it
+    worker.channel->reseed(config.seed, streamId(pointIndex, chunk));
+    worker.messageRng.reseed(config.seed, MESSAGE_STREAM | streamId(pointIndex, chunk));
+
+    for (uint64_t frame = 0; frame < count; frame++)
+    {
+      randomize(worker.message, worker.messageRng);
+      worker.strategy->encode(worker.message, worker.encoded);
+
+      worker.received.assign(worker.encoded);
+      worker.channel->transmit(worker.received);
+      totals.channelBits += worker.encoded.size();
+      totals.channelErrors += Utils::countDifferences(worker.encoded, worker.received, worker.encoded.size());
+
+      totals.correctedErrors += worker.strategy->decode(worker.received, worker.decoded);
+
+      // Missing decoded bits count as errors
+      size_t compared = std::min(messageLength, worker.decoded.size());
+      uint64_t errors = Utils::countDifferences(worker.message, worker.decoded, compared) + (messageLength - compared);
+      totals.bitErrors += errors;
+      totals.messageBits += messageLength;
+      if (errors != 0)
+      {
+        chunkFrameErrors++;
+      }
+    }
+
+    totals.frames += count;
+    totals.frameErrors += chunkFrameErrors;
+    frameErrorsSeen.fetch_add(chunkFrameErrors, std::memory_order_relaxed); });
+
+  // Merge the per-worker counters
+  SweepPoint point;
+  point.strategy = strategyName;
+  point.errorRate = errorRate;
+  for (const auto &worker : workers)
+  {
+    point.frames += worker.totals.frames;
+    point.frameErrors += worker.totals.frameErrors;
+    point.messageBits += worker.totals.messageBits;
+    point.bitErrors += worker.totals.bitErrors;
+    point.channelBits += worker.totals.channelBits;
+    point.channelErrors += worker.totals.channelErrors;
+    point.correctedErrors += worker.totals.correctedErrors;
+  }
+
+  point.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  return point;
+}
+
+void SweepEngine::printHeader(std::ostream &os, bool csv)
+{
+  if (csv)
+  {
+    os << "strategy,error_rate,frames,frame_errors,message_bits,bit_errors,channel_ber,ber,fer,seconds" << std::endl;
+    return;
+  }
+
+  os << std::left << std::setw(20) << "Code"
+     << std::right << std::setw(11) << "Channel p"
+     << std::setw(12) << "Frames"
+     << std::setw(12) << "Raw BER"
+     << std::setw(12) << "BER"
+     << std::setw(12) << "FER"
+     << std::setw(12) << "Mbit/s" << std::endl;
+}
+
+void SweepEngine::printPoint(const SweepPoint &point, std::ostream &os, bool csv)
+{
+  if (csv)
+  {
+    os << "\"" << point.strategy << "\"," << std::scientific << std::setprecision(6)
+       << point.errorRate << "," << point.frames << "," << point.frameErrors << ","
+       << point.messageBits << "," << point.bitErrors << ","
+       << point.getChannelErrorRate() << "," << point.getBitErrorRate() << ","
+       << point.getFrameErrorRate() << "," << std::fixed << std::setprecision(3)
+       << point.seconds << std::endl;
+    return;
+  }
+
+  double throughput = point.seconds > 0 ? point.channelBits / point.seconds / 1e6 : 0.0;
+  os << std::left << std::setw(20) << point.strategy
+     << std::right << std::scientific << std::setprecision(2)
+     << std::setw(11) << point.errorRate
+     << std::setw(12) << point.frames
+     << std::setw(12) << point.getChannelErrorRate()
+     << std::setw(12) << point.getBitErrorRate()
+     << std::setw(12) << point.getFrameErrorRate()
+     << std::fixed << std::setprecision(1)
+     << std::setw(12) << throughput << std::endl;
+}
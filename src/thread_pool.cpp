@@ -0,0 +1,178 @@
+#include "../include/thread_pool.h"
+#include <algorithm>
+
+namespace
+{
+  // Pool whose work the current thread is running, and its worker id there
+  thread_local const ThreadPool *currentPool = nullptr;
+  thread_local unsigned currentWorker = 0;
+
+  // Mark the current thread as a worker of a pool for the lifetime of the object
+  class WorkerScope
+  {
+  public:
+    WorkerScope(const ThreadPool *pool, unsigned worker)
+        : previousPool(currentPool), previousWorker(currentWorker)
+    {
+      currentPool = pool;
+      currentWorker = worker;
+    }
+
+    ~WorkerScope()
+    {
+      currentPool = previousPool;
+      currentWorker = previousWorker;
+    }
+
+    WorkerScope(const WorkerScope &) = delete;
+    WorkerScope &operator=(const WorkerScope &) = delete;
+
+  private:
+    const ThreadPool *previousPool;
+    unsigned previousWorker;
+  };
+}
+
+ThreadPool::ThreadPool(unsigned threads)
+    : job(nullptr), jobSize(0), nextIndex(0), activeWorkers(0), generation(0), stopping(false)
+{
+  if (threads == 0)
+  {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // The caller acts as worker 0, so start one fewer background thread
+  for (unsigned i = 1; i < threads; i++)
+  {
+    workers.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wakeCondition.notify_all();
+
+  for (auto &worker : workers)
+  {
+    worker.join();
+  }
+}
+
+void ThreadPool::runItems(const std::function<void(size_t, unsigned)> &body, size_t count, unsigned worker)
+{
+  try
+  {
+    for (size_t i = nextIndex.fetch_add(1); i < count; i = nextIndex.fetch_add(1))
+    {
+      body(i, worker);
+    }
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!firstError)
+    {
+      firstError = std::current_exception();
+    }
+
+    // Stop handing out further items
+    nextIndex.store(count);
+  }
+}
+
+void ThreadPool::workerLoop(unsigned worker)
+{
+  WorkerScope scope(this, worker);
+  unsigned long seenGeneration = 0;
+
+  while (true)
+  {
+    const std::function<void(size_t, unsigned)> *body;
+    size_t count;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wakeCondition.wait(lock, [&]
+                         { return stopping || generation != seenGeneration; });
+      if (stopping)
+      {
+        return;
+      }
+      seenGeneration = generation;
+      body = job;
+      count = jobSize;
+    }
+
+    runItems(*body, count, worker);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--activeWorkers == 0)
+    {
+      doneCondition.notify_one();
+    }
+  }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t index, unsigned worker)> &body)
+{
+  if (count == 0)
+  {
+    return;
+  }
+
+  // Nested loops run on the worker that started them; the others are busy
+  // with the outer loop, and waiting for them would deadlock
+  if (currentPool == this)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      body(i, currentWorker);
+    }
+    return;
+  }
+
+  // One loop at a time owns the job slots and the workers
+  std::lock_guard<std::mutex> submitLock(submitMutex);
+  WorkerScope scope(this, 0);
+
+  // Run inline when there is nothing to share
+  if (workers.empty() || count == 1)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      body(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &body;
+    jobSize = count;
+    nextIndex.store(0);
+    activeWorkers = static_cast<unsigned>(workers.size());
+    firstError = nullptr;
+    generation++;
+  }
+  wakeCondition.notify_all();
+
+  // The calling thread works too
+  runItems(body, count, 0);
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [&]
+                       { return activeWorkers == 0; });
+    job = nullptr;
+    error = firstError;
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
@@ -5,6 +5,18 @@
 namespace Utils
 {
 
+  namespace
+  {
+    // Reverse the bit order of a byte (packed buffers are LSB-first, characters MSB-first)
+    uint8_t reverseByte(uint8_t b)
+    {
+      b = static_cast<uint8_t>((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+      b = static_cast<uint8_t>((b & 0xCC) >> 2 | (b & 0x33) << 2);
+      b = static_cast<uint8_t>((b & 0xAA) >> 1 | (b & 0x55) << 1);
+      return b;
+    }
+  }
+
   std::vector<bool> stringToBits(const std::string &str)
   {
     std::vector<bool> bits;
@@ -25,6 +37,17 @@ namespace Utils
     return bits;
   }
 
+  void stringToBits(const std::string &str, BitBuffer &bits)
+  {
+    bits.resize(str.length() * 8);
+
+    // Store one character per 8 bits, MSB first
+    for (size_t i = 0; i < str.length(); i++)
+    {
+      bits.setBits(i * 8, 8, reverseByte(static_cast<uint8_t>(str[i])));
+    }
+  }
+
   std::string bitsToString(const std::vector<bool> &bits)
   {
     std::string result;
@@ -53,6 +76,25 @@ namespace Utils
     return result;
   }
 
+  std::string bitsToString(ConstBitSpan bits)
+  {
+    std::string result;
+
+    // Make sure we have complete bytes
+    if (bits.size() % 8 != 0)
+    {
+      return result; // Return empty string if bits don't form complete bytes
+    }
+
+    result.resize(bits.size() / 8);
+    for (size_t i = 0; i < result.size(); i++)
+    {
+      result[i] = static_cast<char>(reverseByte(static_cast<uint8_t>(bits.getBits(i * 8, 8))));
+    }
+
+    return result;
+  }
+
   void printBits(const std::vector<bool> &bits,
                  std::ostream &os,
                  int groupSize)
@@ -91,4 +133,33 @@ namespace Utils
     return differences;
   }
 
+  int64_t countDifferences(ConstBitSpan bits1, ConstBitSpan bits2)
+  {
+    if (bits1.size() != bits2.size())
+    {
+      return -1; // Error: different sizes
+    }
+
+    return static_cast<int64_t>(countDifferences(bits1, bits2, bits1.size()));
+  }
+
+  size_t countDifferences(ConstBitSpan bits1, ConstBitSpan bits2, size_t count)
+  {
+    size_t differences = 0;
+    size_t i = 0;
+
+    // XOR and popcount 64 bits at a time
+    for (; i + 64 <= count; i += 64)
+    {
+      differences += __builtin_popcountll(bits1.getBits(i, 64) ^ bits2.getBits(i, 64));
+    }
+    if (i < count)
+    {
+      int rest = static_cast<int>(count - i);
+      differences += __builtin_popcountll(bits1.getBits(i, rest) ^ bits2.getBits(i, rest));
+    }
+
+    return differences;
+  }
+
 } // namespace Utils
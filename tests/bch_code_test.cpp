@@ -0,0 +1,558 @@
+#include "../include/bch_code.h"
+#include "../include/cpu_features.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cerr << "FAILED: " << what << "\n";
+      failures++;
+    }
+  }
+
+  BitBuffer randomBits(size_t size, std::mt19937_64 &rng)
+  {
+    BitBuffer bits(size);
+    for (size_t i = 0; i < size; i += 64)
+    {
+      bits.setBits(i, static_cast<int>(std::min<size_t>(64, size - i)), rng());
+    }
+    return bits;
+  }
+
+  /*
+   * A binary BCH code built independently of the codec: g(x) is the product
+   * of (x - alpha^c) over the cyclotomic cosets of 1 .. 2t, and codewords
+   * are computed by bit-serial polynomial division.
+   */
+  struct ReferenceCode
+  {
+    int n;
+    int k;
+    int r;
+    std::vector<uint64_t> generator; // Bit d is the coefficient of x^d, x^r excluded
+
+    ReferenceCode(int m, int t, int shortening, int polynomial)
+    {
+      const int order = (1 << m) - 1;
+      std::vector<uint32_t> exp(order);
+      std::vector<int> log(order + 1);
+      uint32_t x = 1;
+      for (int i = 0; i < order; i++)
+      {
+        exp[i] = x;
+        log[x] = i;
+        x <<= 1;
+        if (x >> m)
+        {
+          x ^= static_cast<uint32_t>(polynomial);
+        }
+      }
+      auto mul = [&](uint32_t a, uint32_t b)
+      { return a == 0 || b == 0 ? 0 : exp[(log[a] + log[b]) % order]; };
+
+      std::vector<bool> used(order, false);
+      std::vector<uint32_t> product(1, 1); // Lowest degree first
+      for (int i = 1; i <= 2 * t; i++)
+      {
+        for (int c = i; !used[c]; c = 2 * c % order)
+        {
+          used[c] = true;
+          product.insert(product.begin(), 0);
+          for (size_t j = 0; j + 1 < product.size(); j++)
+          {
+            product[j] ^= mul(product[j + 1], exp[c]);
+          }
+        }
+      }
+
+      r = static_cast<int>(product.size()) - 1;
+      n = order - shortening;
+      k = n - r;
+      generator.assign((r + 63) / 64, 0);
+      for (int d = 0; d < r; d++)
+      {
+        check(product[d] <= 1, "reference generator is binary");
+        generator[d / 64] |= static_cast<uint64_t>(product[d] & 1) << (d % 64);
+      }
+    }
+
+    // bits(x) * x^zeros mod g(x), bit 0 of bits being the highest coefficient
+    std::vector<uint64_t> remainder(ConstBitSpan bits, size_t zeros) const
+    {
+      std::vector<uint64_t> reg(generator.size(), 0);
+      const int words = static_cast<int>(reg.size());
+      for (size_t i = 0; i < bits.size() + zeros; i++)
+      {
+        bool top = (reg[(r - 1) / 64] >> ((r - 1) % 64)) & 1;
+        for (int w = words - 1; w > 0; w--)
+        {
+          reg[w] = reg[w] << 1 | reg[w - 1] >> 63;
+        }
+        reg[0] = reg[0] << 1 | (i < bits.size() && bits[i] ? 1 : 0);
+        if (r % 64 != 0)
+        {
+          reg[words - 1] &= (uint64_t(1) << (r % 64)) - 1;
+        }
+        if (top)
+        {
+          for (int w = 0; w < words; w++)
+          {
+            reg[w] ^= generator[w];
+          }
+        }
+      }
+      return reg;
+    }
+
+    // Message bits, then the parity bits with the coefficient of x^(r-1) first
+    BitBuffer encode(ConstBitSpan message) const
+    {
+      std::vector<uint64_t> parity = remainder(message, r);
+      BitBuffer codeword(message);
+      for (int q = 0; q < r; q++)
+      {
+        int d = r - 1 - q;
+        codeword.pushBack((parity[d / 64] >> (d % 64)) & 1);
+      }
+      return codeword;
+    }
+  };
+
+  struct Parameters
+  {
+    int m;
+    int t;
+    int shortening;
+    int polynomial;
+  };
+
+  std::string describe(const Parameters &p)
+  {
+    std::ostringstream name;
+    name << "BCH(m=" << p.m << ",t=" << p.t << ",shorten=" << p.shortening;
+    if (p.polynomial != 0)
+    {
+      name << ",poly=0x" << std::hex << std::uppercase << p.polynomial;
+    }
+    name << ")";
+    return name.str();
+  }
+
+  // DVB-S2 outer codes (EN 302 307-1, Tables 5a and 5b)
+  const Parameters DVB_S2_NORMAL_RATE_1_2 = {16, 12, 65535 - 32400, 0x1002D};
+  const Parameters DVB_S2_NORMAL_RATE_2_3 = {16, 10, 65535 - 43200, 0x1002D};
+  const Parameters DVB_S2_NORMAL_RATE_8_9 = {16, 8, 65535 - 57600, 0x1002D};
+  const Parameters DVB_S2_SHORT_RATE_1_2 = {14, 12, 16383 - 7200, 0};
+
+  // Field sizes from 2 to 16, full length and shortened
+  const Parameters CODES[] = {
+      {2, 1, 0, 0}, {3, 1, 0, 0}, {4, 2, 0, 0}, {5, 3, 0, 0}, {6, 2, 10, 0}, {7, 4, 0, 0}, {8, 4, 55, 0},
+      {8, 3, 0, 0x187}, {9, 6, 100, 0}, {10, 5, 0, 0}, {11, 8, 1000, 0}, {12, 10, 0, 0}, {13, 8, 4000, 0},
+      {14, 12, 0, 0}, {15, 6, 30000, 0}, {16, 4, 60000, 0}, DVB_S2_SHORT_RATE_1_2, DVB_S2_NORMAL_RATE_2_3,
+      DVB_S2_NORMAL_RATE_8_9};
+
+  // Code dimensions match the reference, and the DVB-S2 tables
+  void dimensions()
+  {
+    for (const Parameters &p : CODES)
+    {
+      BCHCode code(p.m, p.t, p.shortening, p.polynomial);
+      ReferenceCode reference(p.m, p.t, p.shortening, p.polynomial ? p.polynomial : GaloisField::defaultPolynomial(p.m));
+      check(static_cast<int>(code.getCodewordLength()) == reference.n &&
+                static_cast<int>(code.getMessageLength()) == reference.k,
+            describe(p) + " dimensions");
+    }
+
+    check(BCHCode(16, 12, 65535 - 32400, 0x1002D).getMessageLength() == 32208, "DVB-S2 normal rate 1/2 Kbch");
+    check(BCHCode(16, 10, 65535 - 43200, 0x1002D).getMessageLength() == 43040, "DVB-S2 normal rate 2/3 Kbch");
+    check(BCHCode(16, 8, 65535 - 57600, 0x1002D).getMessageLength() == 57472, "DVB-S2 normal rate 8/9 Kbch");
+    check(BCHCode(14, 12, 16383 - 7200).getMessageLength() == 7032, "DVB-S2 short rate 1/2 Kbch");
+  }
+
+  // Single and batch encoding match the bit-serial reference
+  void encodeMatchesReference()
+  {
+    std::mt19937_64 rng(18);
+    for (const Parameters &p : CODES)
+    {
+      BCHCode code(p.m, p.t, p.shortening, p.polynomial);
+      ReferenceCode reference(p.m, p.t, p.shortening, p.polynomial ? p.polynomial : GaloisField::defaultPolynomial(p.m));
+      const size_t count = 3;
+      BitBuffer messages = randomBits(count * reference.k, rng);
+
+      BitBuffer batch(count * reference.n);
+      code.encodeBatch(messages, batch);
+      bool same = true;
+      for (size_t c = 0; c < count; c++)
+      {
+        BitBuffer expected = reference.encode(messages.view().subspan(c * reference.k, reference.k));
+        BitBuffer single;
+        code.encode(messages.view().subspan(c * reference.k, reference.k), single);
+        same = same && single == expected && BitBuffer(batch.view().subspan(c * reference.n, reference.n)) == expected;
+      }
+      check(same, describe(p) + " encodes like the reference");
+    }
+  }
+
+  /*
+   * Up to t errors anywhere in a long shortened codeword are corrected, and
+   * t + 1 are reported as failed (a miscorrection of a DVB-S2 code is far
+   * too unlikely to occur here).
+   */
+  void longCodeCorrects(const Parameters &p)
+  {
+    BCHCode code(p.m, p.t, p.shortening, p.polynomial);
+    const size_t n = code.getCodewordLength();
+    const size_t k = code.getMessageLength();
+    std::mt19937_64 rng(p.t);
+
+    const int errorCounts[] = {0, 1, p.t / 2, p.t, p.t, p.t + 1, p.t + 1};
+    const size_t count = sizeof(errorCounts) / sizeof(errorCounts[0]);
+    BitBuffer messages = randomBits(count * k, rng);
+    BitBuffer received(count * n);
+    code.encodeBatch(messages, received);
+
+    for (size_t c = 0; c < count; c++)
+    {
+      std::vector<size_t> positions;
+      while (static_cast<int>(positions.size()) < errorCounts[c])
+      {
+        // The first and last bits of the codeword are always hit
+        size_t bit = positions.empty() ? 0 : positions.size() == 1 ? n - 1 : rng() % n;
+        if (std::find(positions.begin(), positions.end(), bit) == positions.end())
+        {
+          positions.push_back(bit);
+          received.flip(c * n + bit);
+        }
+      }
+    }
+
+    BitBuffer decoded(count * k);
+    std::vector<CodewordStatus> status(count);
+    code.decodeBatch(received, ConstBitSpan(), decoded, status.data());
+
+    for (size_t c = 0; c < count; c++)
+    {
+      std::string name = describe(p) + " with " + std::to_string(errorCounts[c]) + " errors";
+      bool same = BitBuffer(decoded.view().subspan(c * k, k)) == BitBuffer(messages.view().subspan(c * k, k));
+      if (errorCounts[c] <= p.t)
+      {
+        check(same && !status[c].failed && status[c].corrected == errorCounts[c], name + " corrected");
+      }
+      else
+      {
+        check(!same && status[c].failed && status[c].corrected == 0, name + " reported as failed");
+      }
+
+      BitBuffer single;
+      code.decode(received.view().subspan(c * n, n), single);
+      check(single == BitBuffer(decoded.view().subspan(c * k, k)), name + " decode and decodeBatch agree");
+    }
+  }
+
+  /*
+   * Bounded-distance decoder of a short reference code: every error pattern
+   * of weight up to t, indexed by the remainder it leaves.
+   */
+  struct ReferenceDecoder
+  {
+    const ReferenceCode &code;
+    int t;
+    std::unordered_map<uint64_t, uint64_t> patterns; // Remainder to pattern (bit i for codeword bit i)
+    std::vector<uint64_t> unitRemainders;
+
+    ReferenceDecoder(const ReferenceCode &code, int t) : code(code), t(t)
+    {
+      for (int i = 0; i < code.n; i++)
+      {
+        BitBuffer unit(code.n);
+        unit.set(i, true);
+        unitRemainders.push_back(code.remainder(unit, 0)[0]);
+      }
+      addPatterns(0, 0, 0, 0);
+    }
+
+    void addPatterns(int first, int weight, uint64_t pattern, uint64_t remainder)
+    {
+      check(patterns.emplace(remainder, pattern).second, "reference patterns up to weight t are distinct");
+      if (weight == t)
+      {
+        return;
+      }
+      for (int i = first; i < code.n; i++)
+      {
+        addPatterns(i + 1, weight + 1, pattern | uint64_t(1) << i, remainder ^ unitRemainders[i]);
+      }
+    }
+
+    // The decoded codeword, or nothing if the word is not within t of a codeword
+    bool decode(uint64_t word, uint64_t &codeword) const
+    {
+      BitBuffer bits(code.n);
+      bits.setBits(0, code.n, word);
+      auto found = patterns.find(code.remainder(bits, 0)[0]);
+      if (found == patterns.end())
+      {
+        return false;
+      }
+      codeword = word ^ found->second;
+      return true;
+    }
+  };
+
+  /**
+   * @brief Decode words with a short code, which uses its lookup table, and compare with the reference
+   *
+   * @param p The code
+   * @param words Received words, n bits each
+   * @return int Number of words decoded differently from the reference
+   */
+  int compareWithReference(const Parameters &p, const std::vector<uint64_t> &words)
+  {
+    BCHCode code(p.m, p.t, p.shortening, p.polynomial);
+    ReferenceCode reference(p.m, p.t, p.shortening, GaloisField::defaultPolynomial(p.m));
+    ReferenceDecoder decoder(reference, p.t);
+    const int n = reference.n;
+    const int k = reference.k;
+
+    BitBuffer received(words.size() * n);
+    for (size_t c = 0; c < words.size(); c++)
+    {
+      received.setBits(c * n, n, words[c]);
+    }
+    BitBuffer decoded(words.size() * k);
+    std::vector<CodewordStatus> status(words.size());
+    code.decodeBatch(received, ConstBitSpan(), decoded, status.data());
+
+    int wrong = 0;
+    for (size_t c = 0; c < words.size(); c++)
+    {
+      uint64_t expected = 0;
+      bool correctable = decoder.decode(words[c], expected);
+      uint64_t message = decoded.getBits(c * k, k);
+      if (correctable)
+      {
+        int weight = __builtin_popcountll(expected ^ words[c]);
+        wrong += status[c].failed || status[c].corrected != weight ||
+                 message != (expected & ((uint64_t(1) << k) - 1));
+      }
+      else
+      {
+        wrong += !status[c].failed || status[c].corrected != 0 || message != (words[c] & ((uint64_t(1) << k) - 1));
+      }
+    }
+    return wrong;
+  }
+
+  // Every 15-bit word through the BCH(15,7) table
+  void shortCodeExhaustive()
+  {
+    const Parameters p = {4, 2, 0, 0};
+    std::vector<uint64_t> words(1 << 15);
+    for (size_t w = 0; w < words.size(); w++)
+    {
+      words[w] = w;
+    }
+    check(compareWithReference(p, words) == 0, describe(p) + " decodes every word like the reference");
+  }
+
+  // Codewords with 0 .. t + 2 errors through the tables of longer short codes
+  void shortCodeRandom()
+  {
+    const Parameters codes[] = {{5, 2, 0, 0}, {5, 3, 0, 0}, {6, 2, 0, 0}, {6, 2, 10, 0}, {6, 1, 40, 0}};
+    for (const Parameters &p : codes)
+    {
+      ReferenceCode reference(p.m, p.t, p.shortening, GaloisField::defaultPolynomial(p.m));
+      std::mt19937_64 rng(p.m * 100 + p.t);
+      std::vector<uint64_t> words;
+      for (int c = 0; c < 3000; c++)
+      {
+        BitBuffer codeword = reference.encode(randomBits(reference.k, rng));
+        for (int e = c % (p.t + 3); e > 0; e--)
+        {
+          codeword.flip(rng() % reference.n);
+        }
+        words.push_back(codeword.getBits(0, reference.n));
+      }
+      check(compareWithReference(p, words) == 0, describe(p) + " decodes like the reference");
+    }
+  }
+
+  /*
+   * Tables are shared between codes with the same generator and length:
+   * codes that differ only in length, or only in generator, must each get
+   * their own, also when they are first used from several threads at once.
+   */
+  void sharedTables()
+  {
+    const Parameters codes[] = {{6, 2, 0, 0}, {6, 2, 20, 0}, {6, 2, 41, 0}, {6, 1, 20, 0}, {5, 2, 0, 0}, {5, 1, 0, 0}};
+    const int codeCount = sizeof(codes) / sizeof(codes[0]);
+
+    std::vector<std::vector<uint64_t>> words(codeCount);
+    for (int i = 0; i < codeCount; i++)
+    {
+      const Parameters &p = codes[i];
+      ReferenceCode reference(p.m, p.t, p.shortening, GaloisField::defaultPolynomial(p.m));
+      std::mt19937_64 rng(i);
+      for (int c = 0; c < 500; c++)
+      {
+        BitBuffer codeword = reference.encode(randomBits(reference.k, rng));
+        for (int e = c % (p.t + 2); e > 0; e--)
+        {
+          codeword.flip(rng() % reference.n);
+        }
+        words[i].push_back(codeword.getBits(0, reference.n));
+      }
+    }
+
+    std::vector<int> wrong(2 * codeCount, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 2 * codeCount; i++)
+    {
+      threads.emplace_back([&, i]()
+                           { wrong[i] = compareWithReference(codes[i % codeCount], words[i % codeCount]); });
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+
+    for (int i = 0; i < 2 * codeCount; i++)
+    {
+      check(wrong[i] == 0, describe(codes[i % codeCount]) + " decodes with its own table (thread " + std::to_string(i) + ")");
+    }
+  }
+
+  struct BatchResult
+  {
+    BitBuffer codewords;
+    BitBuffer messages;
+    std::vector<CodewordStatus> status;
+  };
+
+  // Encode the messages, add errors to the codewords listed in noisy, and decode them
+  BatchResult encodeAndDecode(BCHCode &code, const BitBuffer &messages, const std::vector<size_t> &noisy, int t)
+  {
+    const size_t n = code.getCodewordLength();
+    const size_t count = messages.size() / code.getMessageLength();
+    BatchResult result;
+    result.codewords.reset(count * n);
+    code.encodeBatch(messages, result.codewords);
+
+    BitBuffer received(result.codewords);
+    std::mt19937_64 rng(count);
+    for (size_t i = 0; i < noisy.size(); i++)
+    {
+      for (int e = 1 + static_cast<int>(i % (t + 1)); e > 0; e--)
+      {
+        received.flip(noisy[i] * n + rng() % n);
+      }
+    }
+
+    result.messages.reset(messages.size());
+    result.status.resize(count);
+    code.decodeBatch(received, ConstBitSpan(), result.messages, result.status.data());
+    return result;
+  }
+
+  bool sameOutcome(const BatchResult &a, const BatchResult &b)
+  {
+    bool same = a.codewords == b.codewords && a.messages == b.messages && a.status.size() == b.status.size();
+    for (size_t c = 0; same && c < a.status.size(); c++)
+    {
+      same = a.status[c].corrected == b.status[c].corrected && a.status[c].failed == b.status[c].failed;
+    }
+    return same;
+  }
+
+  /*
+   * The carry-less multiply folding and the AVX2 lane syndrome and Chien
+   * kernels give the same codewords, messages and outcomes as the portable
+   * code on the same input. Lane syndromes run when at least four codewords
+   * of a group of 32 have errors, so the batch is decoded once with every
+   * codeword noisy and once with a single noisy codeword per group.
+   */
+  void kernelsMatchPortable()
+  {
+    const Parameters codes[] = {{8, 6, 0, 0}, {10, 5, 0, 0}, {12, 10, 0, 0}, {13, 8, 4000, 0}, {16, 13, 20000, 0},
+                                {16, 25, 10000, 0}, DVB_S2_NORMAL_RATE_8_9};
+    for (const Parameters &p : codes)
+    {
+      BCHCode code(p.m, p.t, p.shortening, p.polynomial);
+      ReferenceCode reference(p.m, p.t, p.shortening, p.polynomial ? p.polynomial : GaloisField::defaultPolynomial(p.m));
+      std::mt19937_64 rng(20);
+      const size_t count = 64;
+      BitBuffer messages = randomBits(count * reference.k, rng);
+
+      std::vector<size_t> everyCodeword;
+      std::vector<size_t> onePerGroup = {5, 40};
+      for (size_t c = 0; c < count; c++)
+      {
+        everyCodeword.push_back(c);
+      }
+
+      BatchResult dense = encodeAndDecode(code, messages, everyCodeword, p.t);
+      BatchResult sparse = encodeAndDecode(code, messages, onePerGroup, p.t);
+      CpuFeatures::setEnabled(false);
+      BatchResult densePortable = encodeAndDecode(code, messages, everyCodeword, p.t);
+      BatchResult sparsePortable = encodeAndDecode(code, messages, onePerGroup, p.t);
+      CpuFeatures::setEnabled(true);
+
+      bool encodedRight = true;
+      for (size_t c = 0; c < count; c += 9)
+      {
+        encodedRight = encodedRight && BitBuffer(dense.codewords.view().subspan(c * reference.n, reference.n)) ==
+                                           reference.encode(messages.view().subspan(c * reference.k, reference.k));
+      }
+      check(encodedRight, describe(p) + " encodes like the reference");
+      check(sameOutcome(dense, densePortable), describe(p) + " kernels match the portable code, every codeword noisy");
+      check(sameOutcome(sparse, sparsePortable), describe(p) + " kernels match the portable code, one noisy codeword per group");
+
+      // Codewords with up to t errors were corrected in both layouts
+      bool corrected = true;
+      for (size_t c = 0; c < count; c++)
+      {
+        if (c % (p.t + 1) != static_cast<size_t>(p.t))
+        {
+          corrected = corrected && !dense.status[c].failed &&
+                      BitBuffer(dense.messages.view().subspan(c * reference.k, reference.k)) ==
+                          BitBuffer(messages.view().subspan(c * reference.k, reference.k));
+        }
+      }
+      check(corrected, describe(p) + " corrects up to t errors");
+      check(sparse.messages == messages, describe(p) + " corrects a single noisy codeword per group");
+    }
+  }
+}
+
+int main()
+{
+  dimensions();
+  encodeMatchesReference();
+  longCodeCorrects(DVB_S2_NORMAL_RATE_1_2);
+  longCodeCorrects(DVB_S2_NORMAL_RATE_8_9);
+  longCodeCorrects(DVB_S2_SHORT_RATE_1_2);
+  shortCodeExhaustive();
+  shortCodeRandom();
+  sharedTables();
+  kernelsMatchPortable();
+
+  if (failures == 0)
+  {
+    std::cout << "bch_code_test: all passed\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#include "../include/ccsds_reed_solomon.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cerr << "FAILED: " << what << "\n";
+      failures++;
+    }
+  }
+
+  /*
+   * Known answers from libfec's encode_rs_ccsds (dual basis) and encode_rs_8
+   * with the CCSDS parameters (conventional basis): the parity of the data
+   * below, in transmission order.
+   */
+
+  // Data symbols i = 0 .. 222
+  const uint8_t DUAL_PARITY[32] = {
+      0x4F, 0xFB, 0x92, 0xDD, 0x55, 0x7E, 0xC6, 0x7F, 0x27, 0xFB, 0x89, 0x82, 0xCF, 0x58, 0xF8, 0xFD,
+      0x02, 0x8A, 0xD1, 0x17, 0xFC, 0xEF, 0x6B, 0x27, 0x93, 0xD0, 0x41, 0x88, 0x26, 0x57, 0x86, 0x51};
+
+  // Data symbols 29 * i + 1 (mod 256), i = 0 .. 222
+  const uint8_t SECOND_PARITY[32] = {
+      0x7D, 0xF9, 0xFA, 0x59, 0x7D, 0x8A, 0x5D, 0x9D, 0xF4, 0xBD, 0xFE, 0x3C, 0x67, 0x63, 0x0B, 0x80,
+      0x78, 0xC8, 0xB5, 0x23, 0xAA, 0xF6, 0xBA, 0x88, 0xF9, 0x3F, 0xCA, 0x8C, 0x4F, 0xD7, 0x2D, 0x81};
+
+  // Data symbols 255 - 3 * i (mod 256), i = 0 .. 127, with 95 symbols of virtual fill
+  const uint8_t SHORTENED_PARITY[32] = {
+      0x30, 0x51, 0xE6, 0x50, 0x0D, 0xB4, 0xE5, 0x02, 0xD8, 0x3D, 0x13, 0x85, 0xC7, 0xFD, 0xD1, 0x18,
+      0x56, 0xC1, 0x38, 0xA6, 0x40, 0x22, 0xD4, 0xB3, 0x8B, 0xA8, 0x50, 0x48, 0xDE, 0x96, 0x52, 0x91};
+
+  // Data symbols i = 0 .. 222, conventional basis
+  const uint8_t CONVENTIONAL_PARITY[32] = {
+      0x2F, 0xBD, 0x4F, 0xB4, 0x74, 0x84, 0x94, 0xB9, 0xAC, 0xD5, 0x54, 0x62, 0x72, 0x12, 0xEE, 0xB3,
+      0xEB, 0xED, 0x41, 0x19, 0x1D, 0xE1, 0xD3, 0x63, 0x20, 0xEA, 0x49, 0x29, 0x0B, 0x25, 0xAB, 0xCF};
+
+  std::vector<uint8_t> makeData(size_t count, int scale, int offset)
+  {
+    std::vector<uint8_t> data(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      data[i] = static_cast<uint8_t>(scale * static_cast<int>(i) + offset);
+    }
+    return data;
+  }
+
+  std::vector<uint8_t> codeword(const std::vector<uint8_t> &data, const uint8_t *parity)
+  {
+    std::vector<uint8_t> symbols(data);
+    symbols.insert(symbols.end(), parity, parity + 32);
+    return symbols;
+  }
+
+  // Symbols are sent most significant bit first
+  BitBuffer toBits(const std::vector<uint8_t> &symbols)
+  {
+    BitBuffer bits;
+    for (uint8_t symbol : symbols)
+    {
+      for (int b = 7; b >= 0; b--)
+      {
+        bits.pushBack((symbol >> b) & 1);
+      }
+    }
+    return bits;
+  }
+
+  std::vector<uint8_t> toSymbols(const BitBuffer &bits)
+  {
+    std::vector<uint8_t> symbols(bits.size() / 8);
+    for (size_t i = 0; i < symbols.size(); i++)
+    {
+      for (int b = 0; b < 8; b++)
+      {
+        symbols[i] = static_cast<uint8_t>(symbols[i] << 1 | bits[i * 8 + b]);
+      }
+    }
+    return symbols;
+  }
+
+  // Symbol p of an interleaved block belongs to codeword p % depth
+  std::vector<uint8_t> interleave(const std::vector<std::vector<uint8_t>> &codewords)
+  {
+    std::vector<uint8_t> block;
+    for (size_t i = 0; i < codewords[0].size(); i++)
+    {
+      for (const std::vector<uint8_t> &c : codewords)
+      {
+        block.push_back(c[i]);
+      }
+    }
+    return block;
+  }
+
+  void encodesTo(CcsdsReedSolomon &code, const std::vector<uint8_t> &data, const std::vector<uint8_t> &expected,
+                 const std::string &name)
+  {
+    BitBuffer encoded;
+    code.encode(toBits(data), encoded);
+    check(toSymbols(encoded) == expected, name + ": known-answer codeword");
+
+    BitBuffer decoded;
+    check(code.decode(encoded, decoded) == 0 && decoded == toBits(data), name + ": clean decode");
+  }
+
+  void knownAnswers()
+  {
+    std::vector<uint8_t> data = makeData(223, 1, 0);
+
+    CcsdsReedSolomon dual;
+    encodesTo(dual, data, codeword(data, DUAL_PARITY), "RS(255,223) dual basis");
+
+    CcsdsReedSolomon conventional(1, 0, false);
+    encodesTo(conventional, data, codeword(data, CONVENTIONAL_PARITY), "RS(255,223) conventional basis");
+  }
+
+  // Virtual fill drops leading zero data symbols, which are not sent
+  void shortenedFrame()
+  {
+    std::vector<uint8_t> data = makeData(128, -3, 255);
+    CcsdsReedSolomon code(1, 95);
+    check(code.getCodewordLength() == 160 * 8, "RS(160,128) codeword length");
+    encodesTo(code, data, codeword(data, SHORTENED_PARITY), "RS(160,128) virtual fill");
+  }
+
+  void interleavedFrame()
+  {
+    std::vector<uint8_t> first = makeData(223, 1, 0);
+    std::vector<uint8_t> second = makeData(223, 29, 1);
+
+    CcsdsReedSolomon code(2);
+    encodesTo(code, interleave({first, second}),
+              interleave({codeword(first, DUAL_PARITY), codeword(second, SECOND_PARITY)}), "RS(255,223) I=2");
+
+    // With virtual fill and depth 4, every codeword of the block is the shortened known answer
+    std::vector<uint8_t> shortened = makeData(128, -3, 255);
+    std::vector<uint8_t> shortenedCodeword = codeword(shortened, SHORTENED_PARITY);
+    CcsdsReedSolomon shortenedCode(4, 95);
+    encodesTo(shortenedCode, interleave({shortened, shortened, shortened, shortened}),
+              interleave({shortenedCodeword, shortenedCodeword, shortenedCodeword, shortenedCodeword}),
+              "RS(160,128) I=4");
+  }
+
+  // A burst of 16 * I symbols puts 16 errors in each codeword of an interleaved block
+  void interleavedBurst()
+  {
+    const int depth = 5;
+    CcsdsReedSolomon code(depth, 95);
+    std::mt19937_64 rng(5);
+    std::vector<uint8_t> data(128 * depth);
+    for (uint8_t &symbol : data)
+    {
+      symbol = static_cast<uint8_t>(rng());
+    }
+
+    BitBuffer message = toBits(data);
+    BitBuffer encoded;
+    code.encode(message, encoded);
+
+    for (int length = 16 * depth; length <= 16 * depth + 1; length++)
+    {
+      BitBuffer received(encoded);
+      size_t start = 8 * (20 + rng() % 40);
+      for (int s = 0; s < length; s++)
+      {
+        received.span().xorBits(start + 8 * s, 8, 1 + rng() % 255);
+      }
+
+      BitBuffer decoded;
+      int fixed = code.decode(received, decoded);
+      if (length == 16 * depth)
+      {
+        check(fixed == length && decoded == message, "burst of 16 * I symbols corrected");
+      }
+      else
+      {
+        check(!(decoded == message), "burst of 16 * I + 1 symbols not corrected");
+      }
+    }
+  }
+}
+
+int main()
+{
+  knownAnswers();
+  shortenedFrame();
+  interleavedFrame();
+  interleavedBurst();
+
+  if (failures == 0)
+  {
+    std::cout << "ccsds_reed_solomon_test: all passed\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+#include "../include/bch_code.h"
+#include "../include/ccsds_reed_solomon.h"
+#include "../include/hamming_code.h"
+#include "../include/reed_solomon.h"
+#include "../include/reed_solomon16.h"
+#include "../include/segmented_code.h"
+#include "../include/thread_pool.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cerr << "FAILED: " << what << "\n";
+      failures++;
+    }
+  }
+
+  BitBuffer randomBits(size_t size, std::mt19937_64 &rng)
+  {
+    BitBuffer bits(size);
+    for (size_t i = 0; i < size; i += 64)
+    {
+      bits.setBits(i, static_cast<int>(std::min<size_t>(64, size - i)), rng());
+    }
+    return bits;
+  }
+
+  // Forwards everything but the batch calls, to run the default batch implementation
+  class DefaultBatch : public CodingStrategy
+  {
+  public:
+    explicit DefaultBatch(std::unique_ptr<CodingStrategy> code) : code(std::move(code)) {}
+    DefaultBatch(const DefaultBatch &other) : CodingStrategy(other), code(other.code->clone()) {}
+
+    std::string getName() const override { return code->getName() + " (default batch)"; }
+    std::string getDescription() const override { return code->getDescription(); }
+    std::unique_ptr<CodingStrategy> clone() const override { return std::make_unique<DefaultBatch>(*this); }
+    size_t getMessageLength() const override { return code->getMessageLength(); }
+    size_t getCodewordLength() const override { return code->getCodewordLength(); }
+
+    using CodingStrategy::encode;
+    using CodingStrategy::decode;
+
+    void encode(ConstBitSpan input, BitBuffer &output) override { code->encode(input, output); }
+    int decode(ConstBitSpan input, BitBuffer &output) override { return code->decode(input, output); }
+
+  private:
+    std::unique_ptr<CodingStrategy> code;
+  };
+
+  /*
+   * A codec under test, and the damage it is given: codewords get no
+   * errors, a correctable number of damaged units (bits or symbols) spread
+   * at random, or a burst of uncorrectable units that must be reported as
+   * failed. Codes that never report failures are expected to miscorrect.
+   */
+  struct Case
+  {
+    std::unique_ptr<CodingStrategy> code;
+    std::unique_ptr<CodingStrategy> wordCode; // Encodes single words when code frames a stream, or null
+    int unitBits;        // Bits per unit of damage
+    int correctable;     // Units always corrected
+    int uncorrectable;   // Units never corrected
+    bool reportsFailure; // Uncorrectable words are reported as failed, and left as received
+  };
+
+  /**
+   * @brief Damage distinct units of one codeword
+   *
+   * @param codeword The codeword
+   * @param unitBits Bits per unit
+   * @param count Number of units
+   * @param burstEnd Zero to spread the units at random, or the unit where a burst must end by
+   * @param rng Random source
+   */
+  void damage(BitSpan codeword, int unitBits, int count, size_t burstEnd, std::mt19937_64 &rng)
+  {
+    const size_t units = codeword.size() / unitBits;
+    const bool burst = burstEnd != 0;
+    std::vector<size_t> chosen;
+    size_t start = burst ? rng() % (burstEnd - count + 1) : 0;
+    while (static_cast<int>(chosen.size()) < count)
+    {
+      size_t unit = burst ? start + chosen.size() : rng() % units;
+      if (std::find(chosen.begin(), chosen.end(), unit) == chosen.end())
+      {
+        chosen.push_back(unit);
+        uint64_t pattern = 1 + rng() % ((uint64_t(1) << unitBits) - 1);
+        codeword.xorBits(unit * unitBits, unitBits, pattern);
+      }
+    }
+  }
+
+  void runCase(Case &c)
+  {
+    CodingStrategy &code = *c.code;
+    const std::string name = code.getName();
+    const size_t k = code.getMessageLength();
+    const size_t n = code.getCodewordLength();
+    const size_t count = 40; // A full lane group of 32 and a partial one
+    std::mt19937_64 rng(n);
+
+    // Batch encoding into an unaligned range matches encoding word by word
+    BitBuffer messages = randomBits(count * k + 3, rng);
+    ConstBitSpan messageRange = messages.view().subspan(3, count * k);
+    BitBuffer encoded(count * n + 5);
+    BitSpan codewordRange = encoded.span().subspan(5, count * n);
+    code.encodeBatch(messageRange, codewordRange);
+
+    CodingStrategy &wordCode = c.wordCode ? *c.wordCode : code;
+    bool sameEncoding = true;
+    BitBuffer single;
+    for (size_t w = 0; w < count; w++)
+    {
+      wordCode.encode(messageRange.subspan(w * k, k), single);
+      sameEncoding = sameEncoding && single == BitBuffer(ConstBitSpan(codewordRange).subspan(w * n, n));
+    }
+    check(sameEncoding, name + ": encodeBatch matches encode");
+
+    // Word w is clean, correctable or uncorrectable by w % 3
+    BitBuffer received(encoded);
+    BitSpan receivedRange = received.span().subspan(5, count * n);
+    int expectedFixed = 0;
+    for (size_t w = 0; w < count; w++)
+    {
+      BitSpan word = receivedRange.subspan(w * n, n);
+      if (w % 3 == 1)
+      {
+        damage(word, c.unitBits, c.correctable, 0, rng);
+        expectedFixed += c.correctable;
+      }
+      else if (w % 3 == 2)
+      {
+        // The burst hits the message, which must then come back as received
+        damage(word, c.unitBits, c.uncorrectable, k / c.unitBits, rng);
+      }
+    }
+
+    // Every status entry is written, also for clean words
+    std::vector<CodewordStatus> status(count, CodewordStatus{-1, true});
+    BitBuffer decoded(count * k + 7);
+    BitSpan decodedRange = decoded.span().subspan(7, count * k);
+    int fixed = code.decodeBatch(receivedRange, ConstBitSpan(), decodedRange, status.data());
+
+    int wrongClean = 0;
+    int wrongCorrectable = 0;
+    int wrongUncorrectable = 0;
+    for (size_t w = 0; w < count; w++)
+    {
+      BitBuffer message(ConstBitSpan(decodedRange).subspan(w * k, k));
+      bool same = message == BitBuffer(messageRange.subspan(w * k, k));
+      if (w % 3 == 0)
+      {
+        wrongClean += !same || status[w].failed || status[w].corrected != 0;
+      }
+      else if (w % 3 == 1)
+      {
+        wrongCorrectable += !same || status[w].failed || status[w].corrected != c.correctable;
+      }
+      else if (c.reportsFailure)
+      {
+        bool asReceived = message == BitBuffer(ConstBitSpan(receivedRange).subspan(w * n, k));
+        wrongUncorrectable += same || !asReceived || !status[w].failed || status[w].corrected != 0;
+      }
+      else
+      {
+        wrongUncorrectable += same || status[w].failed;
+        fixed -= status[w].corrected;
+      }
+    }
+    check(wrongClean == 0, name + ": clean codewords");
+    check(wrongCorrectable == 0, name + ": correctable codewords");
+    check(wrongUncorrectable == 0, name + (c.reportsFailure ? ": uncorrectable codewords fail" : ": uncorrectable codewords are miscorrected"));
+    check(fixed == expectedFixed, name + ": total of corrected errors");
+
+    // Without a status array the messages are the same
+    BitBuffer plain(count * k);
+    code.decodeBatch(receivedRange, ConstBitSpan(), plain, nullptr);
+    check(plain == BitBuffer(ConstBitSpan(decodedRange)), name + ": decoding without status");
+  }
+}
+
+int main()
+{
+  std::vector<Case> cases;
+  cases.push_back({std::make_unique<HammingCode>(), nullptr, 1, 1, 2, false});
+  cases.push_back({std::make_unique<ReedSolomon>(), nullptr, 8, 4, 8, true});
+  cases.push_back({std::make_unique<ReedSolomon>(8, 223, 32), nullptr, 8, 16, 20, true});
+  cases.push_back({std::make_unique<CcsdsReedSolomon>(2, 95), nullptr, 8, 16, 40, true});
+  cases.push_back({std::make_unique<ReedSolomon16>(200, 16), nullptr, 16, 8, 12, true});
+  cases.push_back({std::make_unique<BCHCode>(10, 8), nullptr, 1, 8, 20, true});
+  cases.push_back({std::make_unique<BCHCode>(14, 12, 16383 - 7200), nullptr, 1, 12, 30, true});
+  cases.push_back({std::make_unique<DefaultBatch>(std::make_unique<ReedSolomon>(8, 32, 16)), nullptr, 8, 8, 12, true});
+  cases.push_back({std::make_unique<SegmentedCode>(std::make_unique<BCHCode>(10, 8), std::make_shared<ThreadPool>(4)),
+                   std::make_unique<BCHCode>(10, 8), 1, 8, 20, true});
+
+  for (Case &c : cases)
+  {
+    runCase(c);
+  }
+
+  if (failures == 0)
+  {
+    std::cout << "coding_strategy_test: all passed\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+#include "../include/hamming_code.h"
+#include <iostream>
+#include <random>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cerr << "FAILED: " << what << "\n";
+      failures++;
+    }
+  }
+
+  // Encode the message one zero-padded 4-bit block at a time
+  BitBuffer encodeByBlocks(ConstBitSpan message)
+  {
+    HammingCode code;
+    BitBuffer block, codeword, encoded;
+    encoded.reserve((message.size() + 3) / 4 * 7);
+    for (size_t i = 0; i < message.size(); i += 4)
+    {
+      block.reset(4);
+      block.span().copyFrom(message.subspan(i, std::min<size_t>(4, message.size() - i)));
+      code.encode(block, codeword);
+      encoded.append(codeword);
+    }
+    return encoded;
+  }
+
+  // Messages that are not a multiple of 4 bits are zero padded, whatever follows the span
+  void offsetSubspans()
+  {
+    HammingCode code;
+    BitBuffer ones(192);
+    ones.span().fill(true);
+    BitBuffer encoded;
+
+    struct Case
+    {
+      size_t offset;
+      size_t size;
+    } cases[] = {{2, 62}, {66, 62}, {5, 123}, {1, 33}, {3, 1}, {0, 190}};
+
+    for (const Case &c : cases)
+    {
+      ConstBitSpan message = ones.view().subspan(c.offset, c.size);
+      code.encode(message, encoded);
+      std::string name = "encode subspan(" + std::to_string(c.offset) + ", " + std::to_string(c.size) + ")";
+      check(encoded == encodeByBlocks(message), name);
+
+      BitBuffer decoded;
+      code.decode(encoded, decoded);
+      check(decoded.size() == (c.size + 3) / 4 * 4, name + " decoded size");
+      check(BitBuffer(decoded.view().subspan(0, c.size)) == BitBuffer(message), name + " round trip");
+      check(decoded.view().subspan(c.size, decoded.size() - c.size).count() == 0, name + " zero padding");
+    }
+  }
+
+  // Every single-bit error of every block is corrected
+  void singleErrors()
+  {
+    HammingCode code;
+    std::mt19937_64 rng(7);
+    BitBuffer message(4000), encoded, decoded;
+    for (size_t i = 0; i < message.size(); i += 64)
+    {
+      message.setBits(i, static_cast<int>(std::min<size_t>(64, message.size() - i)), rng());
+    }
+    code.encode(message, encoded);
+
+    size_t blocks = encoded.size() / 7;
+    for (size_t b = 0; b < blocks; b++)
+    {
+      encoded.flip(b * 7 + rng() % 7);
+    }
+    int corrected = code.decode(encoded, decoded);
+    check(corrected == static_cast<int>(blocks), "one correction per block");
+    check(decoded == message, "single errors corrected");
+  }
+}
+
+int main()
+{
+  offsetSubspans();
+  singleErrors();
+
+  if (failures == 0)
+  {
+    std::cout << "hamming_code_test: all passed\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+#include "../include/philox.h"
+#include <iostream>
+#include <string>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cerr << "FAILED: " << what << "\n";
+      failures++;
+    }
+  }
+
+  /*
+   * Known-answer vectors of Philox4x32-10 from Random123 (kat_vectors).
+   * The counter is (c0, c1, c2, c3) = (block, stream) as 32-bit halves, low
+   * first, and the key is (k0, k1) = seed, low half first.
+   */
+  struct KnownAnswer
+  {
+    uint32_t counter[4];
+    uint32_t key[2];
+    uint32_t output[4];
+  };
+
+  const KnownAnswer KNOWN_ANSWERS[] = {
+      {{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+       {0x00000000, 0x00000000},
+       {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+      {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+       {0xffffffff, 0xffffffff},
+       {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+      {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+       {0xa4093822, 0x299f31d0},
+       {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+  };
+
+  uint64_t join(uint32_t low, uint32_t high)
+  {
+    return static_cast<uint64_t>(high) << 32 | low;
+  }
+
+  void knownAnswers()
+  {
+    for (const KnownAnswer &kat : KNOWN_ANSWERS)
+    {
+      uint64_t block = join(kat.counter[0], kat.counter[1]);
+      uint64_t stream = join(kat.counter[2], kat.counter[3]);
+      Philox rng(join(kat.key[0], kat.key[1]), stream);
+      uint64_t expected[2] = {join(kat.output[0], kat.output[1]), join(kat.output[2], kat.output[3])};
+
+      std::string name = "known answer for block " + std::to_string(block);
+      uint64_t out[2];
+      rng.generate(block, out);
+      check(out[0] == expected[0] && out[1] == expected[1], name + " (generate)");
+
+      rng.seek(block);
+      uint64_t first = rng.next();
+      uint64_t second = rng.next();
+      check(first == expected[0] && second == expected[1], name + " (next)");
+    }
+  }
+
+  // fill runs four blocks side by side and must match next() from any position
+  void fillMatchesNext()
+  {
+    for (size_t skip = 0; skip < 3; skip++)
+    {
+      Philox reference(0x0123456789ABCDEF, 42);
+      Philox filled(0x0123456789ABCDEF, 42);
+      for (size_t i = 0; i < skip; i++)
+      {
+        reference.next();
+        filled.next();
+      }
+
+      uint64_t words[37];
+      filled.fill(words, 37);
+      bool same = true;
+      for (uint64_t word : words)
+      {
+        same = same && word == reference.next();
+      }
+      check(same, "fill after " + std::to_string(skip) + " words matches next");
+      check(filled.next() == reference.next(), "fill leaves the position after the last word");
+    }
+  }
+
+  // Streams and seeds select different sequences
+  void streamsDiffer()
+  {
+    uint64_t a[2], b[2], c[2];
+    Philox(7, 0).generate(0, a);
+    Philox(7, 1).generate(0, b);
+    Philox(8, 0).generate(0, c);
+    check(a[0] != b[0] && a[0] != c[0] && b[0] != c[0], "distinct streams and seeds");
+  }
+}
+
+int main()
+{
+  knownAnswers();
+  fillMatchesNext();
+  streamsDiffer();
+
+  if (failures == 0)
+  {
+    std::cout << "philox_test: all passed\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+#include "../include/reed_solomon.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cerr << "FAILED: " << what << "\n";
+      failures++;
+    }
+  }
+
+  const int SYMBOL_SIZE = 8;
+  const int DATA_SIZE = 223;
+  const int PARITY_SIZE = 32;
+  const int LENGTH = DATA_SIZE + PARITY_SIZE;
+
+  // 40 codewords: one full lane group of 32, then 8 decoded one at a time
+  const size_t CODEWORDS = 40;
+
+  BitBuffer randomBits(size_t size, std::mt19937_64 &rng)
+  {
+    BitBuffer bits(size);
+    for (size_t i = 0; i < size; i += 64)
+    {
+      bits.setBits(i, static_cast<int>(std::min<size_t>(64, size - i)), rng());
+    }
+    return bits;
+  }
+
+  /**
+   * @brief Damage one codeword of a stream
+   *
+   * @param received The stream
+   * @param erasures Erasure flags of the stream
+   * @param codeword Index of the codeword
+   * @param errors Symbols to corrupt without flagging them
+   * @param erased Symbols to flag, corrupted or not
+   * @param erasedErrors How many of the flagged symbols are also corrupted
+   */
+  void damage(BitBuffer &received, BitBuffer &erasures, size_t codeword, int errors, int erased,
+              int erasedErrors, std::mt19937_64 &rng)
+  {
+    std::vector<int> symbols(LENGTH);
+    for (int i = 0; i < LENGTH; i++)
+    {
+      symbols[i] = i;
+    }
+    std::shuffle(symbols.begin(), symbols.end(), rng);
+
+    size_t start = codeword * LENGTH * SYMBOL_SIZE;
+    for (int e = 0; e < errors + erased; e++)
+    {
+      size_t bit = start + static_cast<size_t>(symbols[e]) * SYMBOL_SIZE;
+      bool flagged = e >= errors;
+      if (!flagged || e - errors < erasedErrors)
+      {
+        received.span().xorBits(bit, SYMBOL_SIZE, 1 + rng() % 255);
+      }
+      if (flagged)
+      {
+        erasures.set(bit + rng() % SYMBOL_SIZE, true);
+      }
+    }
+  }
+
+  struct Pattern
+  {
+    int errors;
+    int erased;
+    int erasedErrors;
+  };
+
+  /**
+   * @brief Decode a stream where every codeword has the same kind of damage
+   *
+   * @param pattern The damage
+   * @param correctable Whether the codewords must be corrected or reported as failed
+   * @param name Name of the case
+   */
+  void decodePattern(const Pattern &pattern, bool correctable, const std::string &name)
+  {
+    ReedSolomon code(SYMBOL_SIZE, DATA_SIZE, PARITY_SIZE);
+    std::mt19937_64 rng(pattern.errors * 1000 + pattern.erased);
+    BitBuffer message = randomBits(CODEWORDS * DATA_SIZE * SYMBOL_SIZE, rng);
+    BitBuffer encoded;
+    code.encode(message, encoded);
+
+    BitBuffer received(encoded);
+    BitBuffer erasures(encoded.size());
+    for (size_t c = 0; c < CODEWORDS; c++)
+    {
+      damage(received, erasures, c, pattern.errors, pattern.erased, pattern.erasedErrors, rng);
+    }
+
+    BitBuffer decoded;
+    code.decode(received, erasures, decoded);
+    std::vector<CodewordStatus> status(CODEWORDS);
+    BitBuffer batchDecoded(message.size());
+    code.decodeBatch(received, erasures, batchDecoded, status.data());
+
+    int wrong = 0;
+    for (size_t c = 0; c < CODEWORDS; c++)
+    {
+      size_t bits = DATA_SIZE * SYMBOL_SIZE;
+      bool same = BitBuffer(decoded.view().subspan(c * bits, bits)) == BitBuffer(message.view().subspan(c * bits, bits));
+      if (correctable)
+      {
+        wrong += !same || status[c].failed || status[c].corrected != pattern.errors + pattern.erasedErrors;
+      }
+      else
+      {
+        wrong += same || !status[c].failed || status[c].corrected != 0;
+      }
+    }
+    check(decoded == batchDecoded, name + ": decode and decodeBatch agree");
+    check(wrong == 0, name + (correctable ? ": corrected" : ": reported as failed"));
+  }
+
+  // 2e + f <= 2t is corrected, whether the erased symbols are wrong or not
+  void errorsAndErasures()
+  {
+    const Pattern patterns[] = {{16, 0, 0}, {10, 12, 12}, {8, 16, 10}, {1, 30, 30}, {4, 24, 0}, {0, 5, 5}};
+    for (const Pattern &p : patterns)
+    {
+      decodePattern(p, true, std::to_string(p.errors) + " errors and " + std::to_string(p.erased) + " erasures");
+    }
+  }
+
+  // f = 2t erasures and no other errors use up every parity symbol
+  void erasuresOnly()
+  {
+    decodePattern({0, PARITY_SIZE, PARITY_SIZE}, true, "2t erased and wrong symbols");
+    decodePattern({0, PARITY_SIZE, PARITY_SIZE / 2}, true, "2t erasures, half of them wrong");
+  }
+
+  // 2e + f > 2t cannot be corrected and must not be miscorrected
+  void beyondCapacity()
+  {
+    decodePattern({17, 0, 0}, false, "t + 1 errors");
+    decodePattern({12, 10, 10}, false, "12 errors and 10 erasures");
+    decodePattern({9, 16, 16}, false, "9 errors and 16 erasures");
+  }
+
+  // More than 2t erasures are ignored, and the codeword is decoded for errors only
+  void tooManyErasures()
+  {
+    decodePattern({0, PARITY_SIZE + 1, 5}, true, "2t + 1 erasures, 5 of them wrong");
+  }
+
+  // Erasure flags must cover the input exactly
+  void mismatchedErasures()
+  {
+    ReedSolomon code(SYMBOL_SIZE, DATA_SIZE, PARITY_SIZE);
+    std::mt19937_64 rng(3);
+    BitBuffer message = randomBits(2 * DATA_SIZE * SYMBOL_SIZE, rng);
+    BitBuffer encoded;
+    code.encode(message, encoded);
+
+    BitBuffer shortFlags(encoded.size() - SYMBOL_SIZE);
+    BitBuffer longFlags(encoded.size() + 1);
+    BitBuffer decoded(1);
+    check(code.decode(encoded, shortFlags, decoded) == 0 && decoded.empty(), "short erasure flags are rejected by decode");
+    decoded.resize(1);
+    check(code.decode(encoded, longFlags, decoded) == 0 && decoded.empty(), "long erasure flags are rejected by decode");
+
+    BitBuffer messages(message.size());
+    bool thrown = false;
+    try
+    {
+      code.decodeBatch(encoded, shortFlags, messages, nullptr);
+    }
+    catch (const std::invalid_argument &)
+    {
+      thrown = true;
+    }
+    check(thrown, "short erasure flags are rejected by decodeBatch");
+
+    check(code.decode(encoded, BitBuffer(), decoded) == 0 && decoded == message, "no erasure flags");
+  }
+}
+
+int main()
+{
+  errorsAndErasures();
+  erasuresOnly();
+  beyondCapacity();
+  tooManyErasures();
+  mismatchedErasures();
+
+  if (failures == 0)
+  {
+    std::cout << "reed_solomon_test: all passed\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+#include "../include/galois_field.h"
+#include "../include/rs_corrector.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cerr << "FAILED: " << what << "\n";
+      failures++;
+    }
+  }
+
+  /*
+   * A Reed-Solomon code over GF(2^m) built independently of the codecs:
+   * codewords are m(x) * g(x), highest degree first, and the syndromes are
+   * evaluated directly as S_i = r(beta^(firstRoot + i)).
+   */
+  template <typename Symbol>
+  struct TestCode
+  {
+    const GaloisField &field;
+    int dataSize;
+    int paritySize;
+    int firstRoot;
+    int rootStep;
+    std::vector<Symbol> generator; // Highest degree first, generator[0] = 1
+
+    TestCode(int m, int polynomial, int dataSize, int paritySize, int firstRoot, int rootStep)
+        : field(GaloisField::get(m, polynomial)), dataSize(dataSize), paritySize(paritySize),
+          firstRoot(firstRoot), rootStep(rootStep), generator(1, 1)
+    {
+      for (int i = 0; i < paritySize; i++)
+      {
+        Symbol root = static_cast<Symbol>(field.alphaPow(static_cast<int>(
+            static_cast<int64_t>(rootStep) * (firstRoot + i) % field.order)));
+        generator.push_back(0);
+        for (size_t j = generator.size() - 1; j >= 1; j--)
+        {
+          generator[j] ^= field.mul(generator[j - 1], root);
+        }
+      }
+    }
+
+    int length() const { return dataSize + paritySize; }
+
+    std::vector<Symbol> randomCodeword(std::mt19937_64 &rng) const
+    {
+      std::vector<Symbol> codeword(length(), 0);
+      for (int i = 0; i < dataSize; i++)
+      {
+        Symbol symbol = static_cast<Symbol>(rng() % field.size);
+        for (int j = 0; j <= paritySize; j++)
+        {
+          codeword[i + j] ^= field.mul(symbol, generator[j]);
+        }
+      }
+      return codeword;
+    }
+
+    std::vector<Symbol> syndromes(const std::vector<Symbol> &received) const
+    {
+      std::vector<Symbol> result(paritySize);
+      for (int i = 0; i < paritySize; i++)
+      {
+        Symbol x = static_cast<Symbol>(field.alphaPow(static_cast<int>(
+            static_cast<int64_t>(rootStep) * (firstRoot + i) % field.order)));
+        Symbol sum = 0;
+        for (Symbol r : received)
+        {
+          sum = static_cast<Symbol>(field.mul(sum, x) ^ r);
+        }
+        result[i] = sum;
+      }
+      return result;
+    }
+
+    // Codeword indices where lambda vanishes, found by evaluating it everywhere
+    std::vector<int> roots(const std::vector<Symbol> &lambda, int degree) const
+    {
+      std::vector<int> found;
+      const int n = length();
+      for (int j = 0; j < n; j++)
+      {
+        int inverseLog = static_cast<int>((field.order - static_cast<int64_t>(rootStep) * (n - 1 - j) % field.order) % field.order);
+        Symbol x = static_cast<Symbol>(field.alphaPow(inverseLog));
+        Symbol sum = 0;
+        for (int k = degree; k >= 0; k--)
+        {
+          sum = static_cast<Symbol>(field.mul(sum, x) ^ lambda[k]);
+        }
+        if (sum == 0)
+        {
+          found.push_back(j);
+        }
+      }
+      return found;
+    }
+  };
+
+  // Add count errors with nonzero magnitudes at distinct positions taken from candidates
+  template <typename Symbol>
+  void addErrors(std::vector<Symbol> &codeword, std::vector<int> candidates, int count, int fieldSize,
+                 std::mt19937_64 &rng)
+  {
+    std::shuffle(candidates.begin(), candidates.end(), rng);
+    for (int e = 0; e < count; e++)
+    {
+      codeword[candidates[e]] ^= static_cast<Symbol>(1 + rng() % (fieldSize - 1));
+    }
+  }
+
+  std::vector<int> range(int first, int last)
+  {
+    std::vector<int> indices;
+    for (int i = first; i < last; i++)
+    {
+      indices.push_back(i);
+    }
+    return indices;
+  }
+
+  /*
+   * Up to t = paritySize / 2 random errors are corrected, and t + 1 are
+   * reported as a failure with the codeword left unchanged. The errors are
+   * placed anywhere, at the start of the codeword only (the Chien search
+   * stops after the first few indices) and at the end only (it runs to the
+   * last index).
+   */
+  template <typename Symbol>
+  void randomErrors(const TestCode<Symbol> &code, const std::string &name, int trials)
+  {
+    RsCorrector<Symbol> corrector(code.field, code.dataSize, code.paritySize, code.firstRoot, code.rootStep);
+    std::mt19937_64 rng(code.length());
+    const int n = code.length();
+    const int t = code.paritySize / 2;
+    const std::vector<int> placements[] = {range(0, n), range(0, t + 1), range(n - t - 1, n)};
+    const char *placementNames[] = {"anywhere", "at the start", "at the end"};
+
+    for (int p = 0; p < 3; p++)
+    {
+      int wrong = 0;
+      int notFailed = 0;
+      for (int trial = 0; trial < trials; trial++)
+      {
+        std::vector<Symbol> sent = code.randomCodeword(rng);
+        for (int errors = 1; errors <= t + 1; errors++)
+        {
+          std::vector<Symbol> received = sent;
+          addErrors(received, placements[p], errors, code.field.size, rng);
+          std::vector<Symbol> syndromes = code.syndromes(received);
+          std::vector<Symbol> before = received;
+          int fixed = corrector.correct(received.data(), syndromes.data(), nullptr, 0);
+
+          if (errors <= t)
+          {
+            wrong += fixed != errors || received != sent;
+          }
+          else
+          {
+            notFailed += fixed != 0 || received != before;
+          }
+        }
+      }
+      std::string where = name + ", errors " + placementNames[p];
+      check(wrong == 0, where + ": up to t errors corrected");
+      check(notFailed == 0, where + ": t + 1 errors reported as failed");
+    }
+  }
+
+  // locate and the roots-given overload of correct agree with a full root search
+  template <typename Symbol>
+  void externalRoots(const TestCode<Symbol> &code, const std::string &name)
+  {
+    RsCorrector<Symbol> corrector(code.field, code.dataSize, code.paritySize, code.firstRoot, code.rootStep);
+    std::mt19937_64 rng(1);
+    const int t = code.paritySize / 2;
+    int wrong = 0;
+
+    for (int errors = 1; errors <= t; errors++)
+    {
+      std::vector<Symbol> sent = code.randomCodeword(rng);
+      std::vector<Symbol> received = sent;
+      addErrors(received, range(0, code.length()), errors, code.field.size, rng);
+      std::vector<Symbol> syndromes = code.syndromes(received);
+
+      std::vector<Symbol> lambda(code.paritySize + 1);
+      int degree = corrector.locate(syndromes.data(), nullptr, 0, lambda.data());
+      std::vector<int> roots = code.roots(lambda, degree);
+      wrong += degree != errors || static_cast<int>(roots.size()) != degree;
+
+      // A root count that does not match the degree is a failure
+      std::vector<Symbol> copy = received;
+      wrong += corrector.correct(copy.data(), syndromes.data(), nullptr, 0, lambda.data(), degree,
+                                 roots.data(), degree - 1) != 0;
+      wrong += copy != received;
+
+      int fixed = corrector.correct(received.data(), syndromes.data(), nullptr, 0, lambda.data(), degree,
+                                    roots.data(), static_cast<int>(roots.size()));
+      wrong += fixed != errors || received != sent;
+    }
+    check(wrong == 0, name + ": corrections from locate and external roots");
+  }
+
+  // Syndromes from the remainder r(x) mod g(x) match direct evaluation
+  template <typename Symbol>
+  void remainderSyndromes(const TestCode<Symbol> &code, const std::string &name)
+  {
+    RsCorrector<Symbol> corrector(code.field, code.dataSize, code.paritySize, code.firstRoot, code.rootStep);
+    std::mt19937_64 rng(2);
+    int wrong = 0;
+
+    for (int trial = 0; trial < 20; trial++)
+    {
+      std::vector<Symbol> received = code.randomCodeword(rng);
+      addErrors(received, range(0, code.length()), 1 + trial % code.paritySize, code.field.size, rng);
+
+      // Long division by the monic generator
+      std::vector<Symbol> remainder(received);
+      for (int i = 0; i < code.dataSize; i++)
+      {
+        Symbol factor = remainder[i];
+        for (int j = 0; j <= code.paritySize; j++)
+        {
+          remainder[i + j] ^= code.field.mul(factor, code.generator[j]);
+        }
+      }
+
+      std::vector<Symbol> syndromes(code.paritySize);
+      corrector.syndromesFromRemainder(remainder.data() + code.dataSize, syndromes.data());
+      wrong += syndromes != code.syndromes(received);
+    }
+    check(wrong == 0, name + ": syndromes from the remainder");
+  }
+
+  template <typename Symbol>
+  void runAll(const TestCode<Symbol> &code, const std::string &name, int trials)
+  {
+    randomErrors(code, name, trials);
+    externalRoots(code, name);
+    remainderSyndromes(code, name);
+  }
+}
+
+int main()
+{
+  runAll(TestCode<uint8_t>(8, GaloisField::defaultPolynomial(8), 223, 32, 0, 1), "RS(255,223)", 20);
+  runAll(TestCode<uint8_t>(8, 0x187, 223, 32, 112, 11), "CCSDS RS(255,223)", 20);
+  runAll(TestCode<uint8_t>(8, GaloisField::defaultPolynomial(8), 40, 16, 1, 1), "RS(56,40) shortened", 50);
+  runAll(TestCode<uint16_t>(16, GaloisField::defaultPolynomial(16), 984, 16, 0, 1), "RS(1000,984) over GF(2^16)", 5);
+
+  if (failures == 0)
+  {
+    std::cout << "rs_corrector_test: all passed\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+#include "../include/hamming_code.h"
+#include "../include/segmented_code.h"
+#include "../include/thread_pool.h"
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  int failures = 0;
+
+  void check(bool condition, const std::string &what)
+  {
+    if (!condition)
+    {
+      std::cerr << "FAILED: " << what << "\n";
+      failures++;
+    }
+  }
+
+  // Clones of one segmented code share its pool; each thread drives its own clone
+  void concurrentClones()
+  {
+    auto pool = std::make_shared<ThreadPool>(4);
+    SegmentedCode code(std::make_unique<HammingCode>(), pool);
+
+    const int threadCount = 4;
+    std::vector<int> mismatches(threadCount, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+      threads.emplace_back([&, t]()
+                           {
+        std::unique_ptr<CodingStrategy> clone = code.clone();
+        std::mt19937_64 rng(t);
+        BitBuffer message, encoded, decoded;
+        for (int round = 0; round < 50; round++)
+        {
+          message.reset(200000 + rng() % 1000);
+          for (size_t i = 0; i < message.size(); i += 64)
+          {
+            int count = static_cast<int>(std::min<size_t>(64, message.size() - i));
+            message.setBits(i, count, rng());
+          }
+          clone->encode(message, encoded);
+          clone->decode(encoded, decoded);
+          if (!(decoded == message))
+          {
+            mismatches[t]++;
+          }
+        } });
+    }
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+
+    for (int t = 0; t < threadCount; t++)
+    {
+      check(mismatches[t] == 0, "round trip through a clone on thread " + std::to_string(t));
+    }
+  }
+
+  // A loop started from inside a pool worker runs on that worker
+  void nestedLoops()
+  {
+    ThreadPool pool(4);
+    std::atomic<size_t> items(0);
+    std::atomic<int> wrongWorker(0);
+    pool.parallelFor(16, [&](size_t, unsigned worker)
+                     { pool.parallelFor(8, [&](size_t, unsigned inner)
+                                        {
+                                          items++;
+                                          if (inner != worker)
+                                          {
+                                            wrongWorker++;
+                                          }
+                                        }); });
+    check(items == 16 * 8, "every nested item runs");
+    check(wrongWorker == 0, "nested items keep the worker id");
+  }
+}
+
+int main()
+{
+  concurrentClones();
+  nestedLoops();
+
+  if (failures == 0)
+  {
+    std::cout << "segmented_code_test: all passed\n";
+  }
+  return failures == 0 ? 0 : 1;
+}